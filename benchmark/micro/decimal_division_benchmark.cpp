@@ -0,0 +1,105 @@
+// Micro-benchmarks for the division kernels in decimal_division.hpp.
+//
+// Operands are chosen so that every quotient fits in 128 bits, as it does for
+// any pair of DECIMAL(38) inputs under Spark's result types.
+
+#include "microbench_util.hpp"
+#include "decimal_division.hpp"
+
+namespace duckdb {
+
+// Args: scale_adj (0..38), magnitude (0: 9-digit operands, 1: 38-digit dividends).
+// Large dividends overflow 128 bits once scaled for scale_adj >= 1.
+static void BM_SparkDecimalDivide(benchmark::State &state) {
+	auto scale_adj = static_cast<uint32_t>(state.range(0));
+	bool large = state.range(1) != 0;
+	OperandGenerator gen;
+	std::vector<__int128> a(MICROBENCH_BATCH), b(MICROBENCH_BATCH);
+	for (size_t i = 0; i < MICROBENCH_BATCH; i++) {
+		if (large) {
+			// q < 10^(a_digits + scale_adj - b_digits + 1) <= 10^38
+			uint32_t b_digits = std::min<uint32_t>(38, scale_adj + 2);
+			uint32_t a_digits = std::min<uint32_t>(38, 75 - scale_adj);
+			a[i] = gen.SignedDigits(a_digits);
+			b[i] = gen.SignedDigits(b_digits);
+		} else {
+			// 1-9 digit divisors, widened for large scale_adj so that q < 10^38
+			uint32_t b_digits = 1 + static_cast<uint32_t>(gen.rng() % 9);
+			if (scale_adj > 28) {
+				b_digits = std::max(b_digits, scale_adj - 28);
+			}
+			a[i] = gen.SignedDigits(9);
+			b[i] = gen.SignedDigits(b_digits);
+		}
+	}
+	unsigned __int128 pow10_val = scale_adj > 0 ? Pow10_128(scale_adj) : 0;
+	RunBatches(state, [&](size_t i) {
+		auto quotient = SparkDecimalDivide(a[i], b[i], pow10_val);
+		benchmark::DoNotOptimize(quotient);
+	});
+}
+BENCHMARK(BM_SparkDecimalDivide)->ArgNames({"scale_adj", "large"})->ArgsProduct({benchmark::CreateDenseRange(0, 38, 1), {0, 1}});
+
+// Arg: percentage of rows whose scaled dividend overflows 128 bits (scale_adj = 10)
+static void BM_SparkDecimalDivideOverflowMix(benchmark::State &state) {
+	auto overflow_pct = static_cast<uint32_t>(state.range(0));
+	OperandGenerator gen;
+	std::vector<__int128> a(MICROBENCH_BATCH), b(MICROBENCH_BATCH);
+	for (size_t i = 0; i < MICROBENCH_BATCH; i++) {
+		a[i] = gen.SignedDigits(gen.Percent(overflow_pct) ? 38 : 18);
+		b[i] = gen.SignedDigits(12);
+	}
+	unsigned __int128 pow10_val = Pow10_128(10);
+	RunBatches(state, [&](size_t i) {
+		auto quotient = SparkDecimalDivide(a[i], b[i], pow10_val);
+		benchmark::DoNotOptimize(quotient);
+	});
+}
+BENCHMARK(BM_SparkDecimalDivideOverflowMix)->ArgName("overflow_pct")->Arg(0)->Arg(10)->Arg(50)->Arg(100);
+
+// Args: scale_adj; int64 operands of up to 9 digits (SparkDecimalDivideNarrow).
+// scale_adj > 9 exceeds int64 once scaled and takes the 128-bit fallback.
+static void BM_SparkDecimalDivideNarrow(benchmark::State &state) {
+	auto scale_adj = static_cast<uint32_t>(state.range(0));
+	OperandGenerator gen;
+	std::vector<int64_t> a(MICROBENCH_BATCH), b(MICROBENCH_BATCH);
+	for (size_t i = 0; i < MICROBENCH_BATCH; i++) {
+		a[i] = static_cast<int64_t>(gen.SignedDigits(9));
+		b[i] = static_cast<int64_t>(gen.SignedDigits(1 + static_cast<uint32_t>(gen.rng() % 9)));
+	}
+	SparkDivScale scale(scale_adj);
+	RunBatches(state, [&](size_t i) {
+		auto quotient = SparkDecimalDivideNarrow(a[i], b[i], scale);
+		benchmark::DoNotOptimize(quotient);
+	});
+}
+BENCHMARK(BM_SparkDecimalDivideNarrow)->ArgName("scale_adj")->Arg(0)->Arg(6)->Arg(9)->Arg(12)->Arg(18)->Arg(24);
+
+// Args: divisor digits; `price / 100.00`-style constant divisor with the
+// precomputed reciprocal (constant = 1) or the generic kernel (constant = 0).
+static void BM_SparkDecimalDivideConstant(benchmark::State &state) {
+	auto divisor_digits = static_cast<uint32_t>(state.range(0));
+	bool use_constant = state.range(1) != 0;
+	OperandGenerator gen;
+	std::vector<__int128> a(MICROBENCH_BATCH);
+	for (auto &value : a) {
+		value = gen.SignedDigits(18);
+	}
+	__int128 b = static_cast<__int128>(gen.Digits(divisor_digits));
+	SparkConstantDivisor divisor(b);
+	unsigned __int128 pow10_val = Pow10_128(6);
+	if (use_constant) {
+		RunBatches(state, [&](size_t i) {
+			auto quotient = SparkDecimalDivideConstant(a[i], divisor, pow10_val);
+			benchmark::DoNotOptimize(quotient);
+		});
+	} else {
+		RunBatches(state, [&](size_t i) {
+			auto quotient = SparkDecimalDivide(a[i], b, pow10_val);
+			benchmark::DoNotOptimize(quotient);
+		});
+	}
+}
+BENCHMARK(BM_SparkDecimalDivideConstant)->ArgNames({"divisor_digits", "constant"})->ArgsProduct({{3, 19, 30}, {0, 1}});
+
+} // namespace duckdb
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include "wide_integer.hpp"
+
+namespace duckdb {
+
+// Operands per benchmark batch: large enough to defeat branch-history
+// memorization, small enough to stay in L1/L2.
+static constexpr size_t MICROBENCH_BATCH = 4096;
+
+// Time-stamp counter. On x86-64 this counts reference cycles at the nominal
+// frequency, not core cycles, so compare cycles/op within one machine only.
+inline uint64_t ReadCycleCounter() {
+#if defined(__x86_64__)
+	return __rdtsc();
+#elif defined(__aarch64__)
+	uint64_t value;
+	asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+	return value;
+#else
+	return 0;
+#endif
+}
+
+// Deterministic operand generator shared by all benchmarks.
+struct OperandGenerator {
+	std::mt19937_64 rng;
+
+	explicit OperandGenerator(uint64_t seed = 42) : rng(seed) {
+	}
+
+	// Uniform in [10^(digits - 1), 10^digits), never 0; digits in [1, 38]
+	unsigned __int128 Digits(uint32_t digits) {
+		unsigned __int128 low = digits > 1 ? Pow10_128(digits - 1) : 1;
+		unsigned __int128 span = Pow10_128(digits) - low;
+		unsigned __int128 raw = MakeUint128(rng(), rng());
+		return low + raw % span;
+	}
+
+	// Digits() with a random sign
+	__int128 SignedDigits(uint32_t digits) {
+		auto value = static_cast<__int128>(Digits(digits));
+		return (rng() & 1) ? -value : value;
+	}
+
+	bool Percent(uint32_t pct) {
+		return rng() % 100 < pct;
+	}
+};
+
+// Runs `op(i)` over one batch per benchmark iteration and reports
+// time/op and cycles/op alongside Google Benchmark's per-batch time.
+template <class OP>
+inline void RunBatches(benchmark::State &state, OP &&op) {
+	uint64_t cycles = 0;
+	for (auto _ : state) {
+		uint64_t start = ReadCycleCounter();
+		for (size_t i = 0; i < MICROBENCH_BATCH; i++) {
+			op(i);
+		}
+		cycles += ReadCycleCounter() - start;
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * MICROBENCH_BATCH));
+	state.counters["time/op"] = benchmark::Counter(static_cast<double>(MICROBENCH_BATCH),
+	                                               benchmark::Counter::kIsIterationInvariantRate |
+	                                                   benchmark::Counter::kInvert);
+	state.counters["cycles/op"] = benchmark::Counter(static_cast<double>(cycles) / MICROBENCH_BATCH,
+	                                                 benchmark::Counter::kAvgIterations);
+}
+
+} // namespace duckdb
@@ -0,0 +1,67 @@
+// Micro-benchmarks for the 128/256-bit primitives in wide_integer.hpp.
+
+#include "microbench_util.hpp"
+
+namespace duckdb {
+
+// Arg 0: operand digits (small 9, large 38)
+static void BM_Mul128(benchmark::State &state) {
+	auto digits = static_cast<uint32_t>(state.range(0));
+	OperandGenerator gen;
+	std::vector<unsigned __int128> a(MICROBENCH_BATCH), b(MICROBENCH_BATCH);
+	for (size_t i = 0; i < MICROBENCH_BATCH; i++) {
+		a[i] = gen.Digits(digits);
+		b[i] = gen.Digits(digits);
+	}
+	RunBatches(state, [&](size_t i) {
+		auto product = Mul128(a[i], b[i]);
+		benchmark::DoNotOptimize(product);
+	});
+}
+BENCHMARK(BM_Mul128)->ArgName("digits")->Arg(9)->Arg(38);
+
+// Arg 0: which Div256By128 path the operands take
+//   0: numerator < 2^128 (native 128/128)
+//   1: divisor < 2^64 (chained divq)
+//   2: divisor >= 2^64 (Knuth Algorithm D)
+static void BM_Div256By128(benchmark::State &state) {
+	auto path = state.range(0);
+	OperandGenerator gen;
+	std::vector<uint256_t> num(MICROBENCH_BATCH);
+	std::vector<unsigned __int128> den(MICROBENCH_BATCH);
+	for (size_t i = 0; i < MICROBENCH_BATCH; i++) {
+		if (path == 0) {
+			num[i] = {0, gen.Digits(38)};
+			den[i] = gen.Digits(10);
+		} else if (path == 1) {
+			// 10^19 < 2^64; the quotient stays below 2^128
+			den[i] = gen.Digits(19);
+			num[i] = Mul128(gen.Digits(38), gen.Digits(18));
+		} else {
+			den[i] = gen.Digits(30);
+			num[i] = Mul128(gen.Digits(38), gen.Digits(29));
+		}
+	}
+	RunBatches(state, [&](size_t i) {
+		unsigned __int128 remainder;
+		auto quotient = Div256By128(num[i], den[i], &remainder);
+		benchmark::DoNotOptimize(quotient);
+		benchmark::DoNotOptimize(remainder);
+	});
+}
+BENCHMARK(BM_Div256By128)->ArgName("path")->DenseRange(0, 2);
+
+static void BM_Pow10_128(benchmark::State &state) {
+	OperandGenerator gen;
+	std::vector<uint32_t> exps(MICROBENCH_BATCH);
+	for (auto &exp : exps) {
+		exp = static_cast<uint32_t>(gen.rng() % 39);
+	}
+	RunBatches(state, [&](size_t i) {
+		auto pow = Pow10_128(exps[i]);
+		benchmark::DoNotOptimize(pow);
+	});
+}
+BENCHMARK(BM_Pow10_128);
+
+} // namespace duckdb
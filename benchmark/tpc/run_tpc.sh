@@ -0,0 +1,121 @@
+#!/usr/bin/env bash
+# TPC-H / TPC-DS end to end: every standard query on stock DuckDB, timed
+# against the same query with Spark semantics (see benchmark/README.md).
+#
+# Usage: benchmark/tpc/run_tpc.sh [tpch|tpcds] [scale factor]
+#
+# Environment:
+#   SPARK_DUCKDB  DuckDB CLI with the extension linked in (default ./build/release/duckdb)
+#   STOCK_DUCKDB  DuckDB CLI of the same version without it (default ./duckdb/build/release/duckdb)
+#   TPC_DATA_DIR  where generated databases are kept (default ./build/tpc)
+#   TPC_RUNS      timed runs per query after one warm-up; the median is reported (default 3)
+#   TPC_QUERIES   space-separated query numbers (default: all)
+set -euo pipefail
+
+SUITE=${1:-tpch}
+SF=${2:-1}
+SPARK_DUCKDB=${SPARK_DUCKDB:-./build/release/duckdb}
+STOCK_DUCKDB=${STOCK_DUCKDB:-./duckdb/build/release/duckdb}
+TPC_DATA_DIR=${TPC_DATA_DIR:-./build/tpc}
+TPC_RUNS=${TPC_RUNS:-3}
+
+case "$SUITE" in
+tpch)
+	GENERATE="CALL dbgen(sf = $SF)"
+	QUERIES="tpch_queries()"
+	;;
+tpcds)
+	GENERATE="CALL dsdgen(sf = $SF)"
+	QUERIES="tpcds_queries()"
+	;;
+*)
+	echo "unknown suite '$SUITE' (expected tpch or tpcds)" >&2
+	exit 1
+	;;
+esac
+
+for bin in "$SPARK_DUCKDB" "$STOCK_DUCKDB"; do
+	if [ ! -x "$bin" ]; then
+		echo "$bin not found; build it with 'make bench-tpc' or set SPARK_DUCKDB / STOCK_DUCKDB" >&2
+		exit 1
+	fi
+done
+
+# Data is generated once per suite and scale factor, then opened read-only
+mkdir -p "$TPC_DATA_DIR"
+DB="$TPC_DATA_DIR/${SUITE}_sf${SF}.duckdb"
+if [ ! -f "$DB" ]; then
+	echo "Generating $SUITE at scale factor $SF into $DB" >&2
+	"$STOCK_DUCKDB" "$DB" -c "$GENERATE"
+fi
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+# The Spark variant calls spark_sum / spark_avg for sum / avg. DECIMAL `/`,
+# `*`, `+` and `-` already resolve to the extension's Spark kernels
+# (spark_decimal_div, spark_decimal_mul, ...) through its operator overloads.
+spark_rewrite() {
+	sed -E 's/\b(sum|avg)[[:space:]]*\(/spark_\1(/Ig'
+}
+
+# Median of the numbers on stdin, one per line
+median() {
+	sort -n | awk '{ t[NR] = $1 }
+		END {
+			if (NR == 0) print "error"
+			else if (NR % 2) print t[(NR + 1) / 2]
+			else print (t[NR / 2] + t[NR / 2 + 1]) / 2
+		}'
+}
+
+# Prints the median wall time in seconds of TPC_RUNS runs of a query file, or
+# "error" if the query fails
+time_query() {
+	local bin=$1 query=$2 output
+	{
+		echo ".timer on"
+		echo ".mode trash"
+		for _ in $(seq 0 "$TPC_RUNS"); do
+			cat "$query"
+			echo ";"
+		done
+	} >"$WORK/run.sql"
+	if ! output=$("$bin" -bail -readonly "$DB" <"$WORK/run.sql" 2>&1); then
+		echo "error"
+		return
+	fi
+	# The first run is the warm-up
+	echo "$output" | grep -o 'Run Time (s): real [0-9.]*' | awk '{ print $5 }' | tail -n +2 | median
+}
+
+# spark / stock
+ratio() {
+	awk -v a="$1" -v b="$2" 'BEGIN { printf "%.2f", (b > 0 ? a / b : 0) }'
+}
+
+add() {
+	awk -v a="$1" -v b="$2" 'BEGIN { print a + b }'
+}
+
+QUERY_NRS=${TPC_QUERIES:-$("$STOCK_DUCKDB" -noheader -list -c "SELECT query_nr FROM $QUERIES ORDER BY query_nr")}
+
+printf '%s SF %s, median of %s runs (seconds)\n' "$SUITE" "$SF" "$TPC_RUNS"
+printf '%-6s %10s %10s %8s\n' query stock spark ratio
+stock_total=0
+spark_total=0
+for nr in $QUERY_NRS; do
+	"$STOCK_DUCKDB" -noheader -list -c "SELECT query FROM $QUERIES WHERE query_nr = $nr" |
+	    sed -E 's/;[[:space:]]*$//' >"$WORK/stock.sql"
+	spark_rewrite <"$WORK/stock.sql" >"$WORK/spark.sql"
+	stock=$(time_query "$STOCK_DUCKDB" "$WORK/stock.sql")
+	spark=$(time_query "$SPARK_DUCKDB" "$WORK/spark.sql")
+	if [ "$stock" = "error" ] || [ "$spark" = "error" ]; then
+		printf 'q%-5s %10s %10s %8s\n' "$nr" "$stock" "$spark" "-"
+		continue
+	fi
+	printf 'q%-5s %10s %10s %8s\n' "$nr" "$stock" "$spark" "$(ratio "$spark" "$stock")"
+	stock_total=$(add "$stock_total" "$stock")
+	spark_total=$(add "$spark_total" "$spark")
+done
+printf '%-6s %10s %10s %8s\n' total "$stock_total" "$spark_total" "$(ratio "$spark_total" "$stock_total")"
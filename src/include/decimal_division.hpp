@@ -4,59 +4,387 @@
 
 namespace duckdb {
 
+// Part of the DECIMAL range checks (SparkEnforceDecimalRange): a quotient of
+// 10^38 or more is out of range for every result type, and one of 2^127 or
+// more would wrap when the sign is applied. Clamps it to 10^38 so that the
+// range check sees it.
+inline unsigned __int128 SparkClampQuotient(unsigned __int128 quotient) {
+	unsigned __int128 limit = Pow10_128(38);
+	return quotient < limit ? quotient : limit;
+}
+
+// ROUND_HALF_UP and sign application shared by the division variants.
+//
+// quotient / remainder are the truncated result of |scaled a| / abs_b.
+inline __int128 SparkRoundHalfUp(unsigned __int128 quotient, unsigned __int128 remainder, unsigned __int128 abs_b,
+                                 bool negative) {
+	quotient = SparkClampQuotient(quotient);
+
+	// ROUND_HALF_UP: round away from zero when remainder >= half of divisor.
+	// Branchless: add 1 if (2 * remainder >= abs_b), 0 otherwise.
+	// Note: 2 * remainder cannot overflow unsigned __int128 because
+	// remainder < abs_b <= 10^38, and 2 * 10^38 < 2^128.
+	quotient += static_cast<unsigned __int128>(remainder * 2 >= abs_b);
+
+	// Apply sign branchlessly using two's complement arithmetic:
+	// If negative: result = ~quotient + 1 = -(quotient)
+	// If positive: result = quotient
+	unsigned __int128 sign_mask = -static_cast<unsigned __int128>(negative);
+	unsigned __int128 result_unsigned = (quotient ^ sign_mask) + (sign_mask & 1);
+	return static_cast<__int128>(result_unsigned);
+}
+
+// Truncated division of the scaled dividend |a| * pow10_val by abs_b, shared by
+// SparkDecimalDivide and the integral divide / remainder kernels.
+//
+// pow10_val and pow10_extra follow the SparkDecimalDivide contract (0 skips
+// the scaling). The remainder is always exact. Returns false when the quotient
+// needs more than 128 bits; `quotient` is then unspecified.
+inline bool SparkDecimalDivMod(unsigned __int128 abs_a, unsigned __int128 pow10_val, unsigned __int128 abs_b,
+                               unsigned __int128 &quotient, unsigned __int128 &remainder, uint64_t pow10_extra = 1) {
+	if (__builtin_expect(pow10_extra != 1, 0)) {
+		// 10^scale_adj needs more than 128 bits: divide |a| * 10^38 first, then the
+		// remainder times pow10_extra. remainder < abs_b, so the second dividend
+		// stays below abs_b * 2^128 and its quotient fits.
+		unsigned __int128 high;
+		bool fits = SparkDecimalDivMod(abs_a, pow10_val, abs_b, high, remainder);
+		unsigned __int128 low = Div256By128(Mul128(remainder, pow10_extra), abs_b, &remainder);
+		return fits && !__builtin_mul_overflow(high, pow10_extra, &high) &&
+		       !__builtin_add_overflow(high, low, &quotient);
+	}
+	unsigned __int128 scaled = abs_a;
+	// __builtin_mul_overflow compiles to a single mul instruction + flag check,
+	// avoiding the expensive division (UINT128_MAX / abs_a) of the naive approach.
+	if (__builtin_expect(pow10_val == 0 || !__builtin_mul_overflow(abs_a, pow10_val, &scaled), 1)) {
+		// Fast path: fits in 128 bits, often in 64
+		if (((scaled | abs_b) >> 64) == 0) {
+			quotient = static_cast<uint64_t>(scaled) / static_cast<uint64_t>(abs_b);
+			remainder = static_cast<uint64_t>(scaled) % static_cast<uint64_t>(abs_b);
+			return true;
+		}
+		quotient = scaled / abs_b;
+		remainder = scaled % abs_b;
+		return true;
+	}
+	// Slow path: use 256-bit intermediate
+	uint256_t scaled_wide = Mul128(abs_a, pow10_val);
+	// Div256By128 saturates a quotient beyond 128 bits and keeps the remainder exact
+	quotient = Div256By128(scaled_wide, abs_b, &remainder);
+	return scaled_wide.hi < abs_b;
+}
+
 // Perform decimal division with ROUND_HALF_UP rounding (Spark semantics).
 //
 // Given two scaled integers a and b (representing DECIMAL values),
 // compute: result = (a * pow10_val) / b, rounded HALF_UP.
 //
 // pow10_val must be precomputed as Pow10_128(scale_adj) by the caller.
-// When scale_adj == 0, pass pow10_val = 0 to skip scaling entirely.
+// When scale_adj == 0, pass pow10_val = 0 to skip scaling entirely. A
+// scale_adj above 38 is split into pow10_val = 10^38 and
+// pow10_extra = 10^(scale_adj - 38); SparkDivScale does both.
 //
-// Returns the result as a signed __int128.
+// Returns the result as a signed __int128. A quotient beyond 128 bits is
+// returned as 10^38, which is outside every DECIMAL result and is caught by the
+// caller's range check.
 // Caller must handle division by zero before calling this function.
-inline __int128 SparkDecimalDivide(__int128 a, __int128 b, unsigned __int128 pow10_val) {
+inline __int128 SparkDecimalDivide(__int128 a, __int128 b, unsigned __int128 pow10_val, uint64_t pow10_extra = 1) {
 	// Handle signs separately, work with absolute values
 	bool negative = (a < 0) != (b < 0);
-	unsigned __int128 abs_a = Abs128(a);
 	unsigned __int128 abs_b = Abs128(b);
 
 	unsigned __int128 quotient;
 	unsigned __int128 remainder;
+	if (__builtin_expect(!SparkDecimalDivMod(Abs128(a), pow10_val, abs_b, quotient, remainder, pow10_extra), 0)) {
+		quotient = Pow10_128(38);
+		remainder = 0;
+	}
+
+	return SparkRoundHalfUp(quotient, remainder, abs_b, negative);
+}
+
+// 64-bit counterpart of SparkRoundHalfUp.
+inline int64_t SparkRoundHalfUp64(uint64_t quotient, uint64_t remainder, uint64_t abs_b, bool negative) {
+	// ROUND_HALF_UP, same branchless form as the 128-bit version
+	quotient += static_cast<uint64_t>(remainder * 2 >= abs_b);
+
+	uint64_t sign_mask = -static_cast<uint64_t>(negative);
+	return static_cast<int64_t>((quotient ^ sign_mask) + (sign_mask & 1));
+}
+
+// 64-bit counterpart of SparkDecimalDivide for operands stored in at most
+// 64 bits (DECIMAL precision <= 18).
+//
+// scaled_a is the dividend already multiplied by 10^scale_adj; the caller
+// guarantees that this product fits in int64_t. Because |scaled_a| < 2^63,
+// the quotient always fits and 2 * remainder cannot overflow uint64_t.
+// Caller must handle division by zero before calling this function.
+inline int64_t SparkDecimalDivide64(int64_t scaled_a, int64_t b) {
+	bool negative = (scaled_a < 0) != (b < 0);
+	uint64_t abs_a = scaled_a < 0 ? -static_cast<uint64_t>(scaled_a) : static_cast<uint64_t>(scaled_a);
+	uint64_t abs_b = b < 0 ? -static_cast<uint64_t>(b) : static_cast<uint64_t>(b);
+
+	uint64_t quotient = abs_a / abs_b;
+	uint64_t remainder = abs_a % abs_b;
+
+	return SparkRoundHalfUp64(quotient, remainder, abs_b, negative);
+}
+
+// Scaling factors for one division, precomputed once per vector from scale_adj.
+//
+// scale_adj reaches 44 (DECIMAL(38,0) / DECIMAL(38,38) -> DECIMAL(38,6)), past
+// the largest power of ten in 128 bits; the factor is then split into
+// pow10_val = 10^38 and pow10_extra = 10^(scale_adj - 38).
+struct SparkDivScale {
+	unsigned __int128 pow10_val; // 10^min(scale_adj, 38), or 0 when scale_adj == 0 (SparkDecimalDivide contract)
+	uint64_t pow10_extra;        // 10^(scale_adj - 38) when scale_adj > 38, otherwise 1
+	int64_t pow10_64;            // 10^scale_adj when it fits in int64_t, otherwise 0
+	// Not known without the exponent: a 64-bit dividend may need the 256-bit path
+	static constexpr bool NARROW_FITS_128 = false;
+
+	explicit SparkDivScale(uint32_t scale_adj)
+	    : pow10_val(scale_adj > 0 ? Pow10_128(scale_adj < 38 ? scale_adj : 38) : 0),
+	      pow10_extra(scale_adj > 38 ? static_cast<uint64_t>(Pow10_128(scale_adj - 38)) : 1),
+	      pow10_64(scale_adj <= 18 ? static_cast<int64_t>(Pow10_128(scale_adj)) : 0) {
+	}
+
+	// The largest |a| whose scaled value |a| * 10^scale_adj fits in 128 bits;
+	// larger dividends take the 256-bit path
+	unsigned __int128 MaxDividend128() const {
+		if (pow10_extra != 1) {
+			return 0;
+		}
+		return ~static_cast<unsigned __int128>(0) / (pow10_val != 0 ? pow10_val : 1);
+	}
+};
+
+// SparkDivScale with scale_adj fixed at compile time. The factors become
+// immediates, and the kernels drop the branches they decide.
+template <uint32_t SCALE_ADJ>
+struct SparkDivFixedScale {
+	static constexpr unsigned __int128 pow10_val = SCALE_ADJ > 0 ? Pow10Constexpr(SCALE_ADJ) : 0;
+	static constexpr uint64_t pow10_extra = 1;
+	static constexpr int64_t pow10_64 = SCALE_ADJ <= 18 ? static_cast<int64_t>(Pow10Constexpr(SCALE_ADJ)) : 0;
+	// |a| < 2^63 and 10^SCALE_ADJ < 2^64: a 64-bit dividend scales within 128 bits
+	static constexpr bool NARROW_FITS_128 = SCALE_ADJ <= 19;
+};
+
+template <uint32_t SCALE_ADJ>
+constexpr unsigned __int128 SparkDivFixedScale<SCALE_ADJ>::pow10_val;
+template <uint32_t SCALE_ADJ>
+constexpr uint64_t SparkDivFixedScale<SCALE_ADJ>::pow10_extra;
+template <uint32_t SCALE_ADJ>
+constexpr int64_t SparkDivFixedScale<SCALE_ADJ>::pow10_64;
+template <uint32_t SCALE_ADJ>
+constexpr bool SparkDivFixedScale<SCALE_ADJ>::NARROW_FITS_128;
+
+// Division of operands stored in at most 64 bits.
+//
+// Uses 64-bit arithmetic whenever a * 10^scale_adj fits in int64_t and only
+// falls back to the 128/256-bit SparkDecimalDivide when it does not.
+// SCALE is SparkDivScale or SparkDivFixedScale.
+template <typename SCALE>
+inline __int128 SparkDecimalDivideNarrow(int64_t a, int64_t b, const SCALE &scale) {
+	int64_t scaled_a;
+	if (__builtin_expect(scale.pow10_64 != 0 && !__builtin_mul_overflow(a, scale.pow10_64, &scaled_a), 1)) {
+		return SparkDecimalDivide64(scaled_a, b);
+	}
+	if (SCALE::NARROW_FITS_128) {
+		unsigned __int128 abs_b = Abs128(b);
+		unsigned __int128 scaled = Abs128(a) * scale.pow10_val;
+		return SparkRoundHalfUp(scaled / abs_b, scaled % abs_b, abs_b, (a < 0) != (b < 0));
+	}
+	return SparkDecimalDivide(a, b, scale.pow10_val, scale.pow10_extra);
+}
+
+// ---------------------------------------------------------------------------
+// Constant divisor: precomputed reciprocals
+// ---------------------------------------------------------------------------
+// When the divisor is the same for a whole vector (or a whole query, e.g.
+// `price / 100.00`), the per-row 128-bit divide is replaced by a multiply
+// with a precomputed reciprocal. The quotient is exact, so the remainder and
+// therefore the HALF_UP rounding are bit-identical to SparkDecimalDivide.
+
+struct SparkConstantDivisor {
+	unsigned __int128 abs_b;
+	bool negative;
+	bool fits_64; // abs_b < 2^64: the 64-bit reciprocal is usable
+	Reciprocal64 rcp64;
+	Reciprocal128 rcp128;
+	// 10^scale_adj / b (signed) when b divides 10^scale_adj, otherwise 0; see
+	// SetExactMultiplier
+	__int128 exact_multiplier;
+
+	SparkConstantDivisor() : abs_b(0), negative(false), fits_64(false), rcp64(), rcp128(), exact_multiplier(0) {
+	}
 
-	if (pow10_val == 0) {
-		// No scaling needed (scale_adj was 0)
-		quotient = abs_a / abs_b;
-		remainder = abs_a % abs_b;
-	} else {
-		// Check if abs_a * pow10_val would overflow unsigned __int128
-		// __builtin_mul_overflow compiles to a single mul instruction + flag check,
-		// avoiding the expensive division (UINT128_MAX / abs_a) of the naive approach.
-		unsigned __int128 scaled;
-		bool overflow = __builtin_mul_overflow(abs_a, pow10_val, &scaled);
-
-		if (__builtin_expect(!overflow, 1)) {
-			// Fast path: fits in 128 bits
-			quotient = scaled / abs_b;
-			remainder = scaled % abs_b;
+	// b must be non-zero
+	explicit SparkConstantDivisor(__int128 b)
+	    : abs_b(Abs128(b)), negative(b < 0), fits_64((abs_b >> 64) == 0),
+	      rcp64(fits_64 ? MakeReciprocal64(static_cast<uint64_t>(abs_b)) : Reciprocal64()),
+	      rcp128(MakeReciprocal128(abs_b)), exact_multiplier(0) {
+	}
+
+	bool Matches(__int128 b) const {
+		return abs_b == Abs128(b) && negative == (b < 0);
+	}
+
+	// Division by a divisor of 10^scale_adj (10.0, 100, 0.5, 25, ...) is exact:
+	// a * 10^scale_adj / b = a * (10^scale_adj / b), with no remainder to round.
+	// Returns whether that holds.
+	bool SetExactMultiplier(uint32_t scale_adj) {
+		if (scale_adj > 38 || Pow10_128(scale_adj) % abs_b != 0) {
+			return false;
+		}
+		auto multiplier = static_cast<__int128>(Pow10_128(scale_adj) / abs_b);
+		exact_multiplier = negative ? -multiplier : multiplier;
+		return true;
+	}
+};
+
+// SparkDecimalDivideConstant when divisor.exact_multiplier is set: one multiply.
+// A product beyond 128 bits is returned as +-10^38 (see SparkDecimalDivide).
+inline __int128 SparkDecimalDivideExact(__int128 a, const SparkConstantDivisor &divisor) {
+	__int128 result;
+	if (__builtin_expect(__builtin_mul_overflow(a, divisor.exact_multiplier, &result), 0)) {
+		auto saturated = static_cast<__int128>(Pow10_128(38));
+		return (a < 0) != divisor.negative ? -saturated : saturated;
+	}
+	return result;
+}
+
+// SparkDecimalDivide with a constant divisor. Same contract for pow10_val and
+// pow10_extra.
+inline __int128 SparkDecimalDivideConstant(__int128 a, const SparkConstantDivisor &divisor,
+                                           unsigned __int128 pow10_val, uint64_t pow10_extra = 1) {
+	bool negative = (a < 0) != divisor.negative;
+	unsigned __int128 abs_a = Abs128(a);
+	unsigned __int128 abs_b = divisor.abs_b;
+
+	unsigned __int128 quotient;
+	unsigned __int128 remainder;
+
+	unsigned __int128 scaled = abs_a;
+	bool overflow = pow10_extra != 1 || (pow10_val != 0 && __builtin_mul_overflow(abs_a, pow10_val, &scaled));
+
+	if (__builtin_expect(!overflow, 1)) {
+		if ((scaled >> 64) == 0 && divisor.fits_64) {
+			uint64_t q64 = DivideByReciprocal(static_cast<uint64_t>(scaled), divisor.rcp64);
+			quotient = q64;
 		} else {
-			// Slow path: use 256-bit intermediate
-			uint256_t scaled_wide = Mul128(abs_a, pow10_val);
-			quotient = Div256By128(scaled_wide, abs_b, &remainder);
+			quotient = DivideByReciprocal(scaled, divisor.rcp128);
 		}
+		remainder = scaled - quotient * abs_b;
+	} else if (!SparkDecimalDivMod(abs_a, pow10_val, abs_b, quotient, remainder, pow10_extra)) {
+		// Slow path: the scaled dividend needs 256 bits; a quotient beyond 128
+		// bits is reported as 10^38 (see SparkDecimalDivide)
+		quotient = Pow10_128(38);
+		remainder = 0;
 	}
 
-	// ROUND_HALF_UP: round away from zero when remainder >= half of divisor.
-	// Branchless: add 1 if (2 * remainder >= abs_b), 0 otherwise.
-	// Note: 2 * remainder cannot overflow unsigned __int128 because
-	// remainder < abs_b <= 10^38, and 2 * 10^38 < 2^128.
-	quotient += static_cast<unsigned __int128>(remainder * 2 >= abs_b);
+	return SparkRoundHalfUp(quotient, remainder, abs_b, negative);
+}
 
-	// Apply sign branchlessly using two's complement arithmetic:
-	// If negative: result = ~quotient + 1 = -(quotient)
-	// If positive: result = quotient
-	unsigned __int128 sign_mask = -static_cast<unsigned __int128>(negative);
-	unsigned __int128 result_unsigned = (quotient ^ sign_mask) + (sign_mask & 1);
-	return static_cast<__int128>(result_unsigned);
+// SparkDecimalDivide64 with a constant divisor (divisor.fits_64 must hold).
+inline int64_t SparkDecimalDivide64Constant(int64_t scaled_a, const SparkConstantDivisor &divisor) {
+	bool negative = (scaled_a < 0) != divisor.negative;
+	uint64_t abs_a = scaled_a < 0 ? -static_cast<uint64_t>(scaled_a) : static_cast<uint64_t>(scaled_a);
+	uint64_t abs_b = static_cast<uint64_t>(divisor.abs_b);
+
+	uint64_t quotient = DivideByReciprocal(abs_a, divisor.rcp64);
+	uint64_t remainder = abs_a - quotient * abs_b;
+
+	return SparkRoundHalfUp64(quotient, remainder, abs_b, negative);
+}
+
+// SparkDecimalDivideNarrow with a constant divisor.
+template <typename SCALE>
+inline __int128 SparkDecimalDivideNarrowConstant(int64_t a, const SparkConstantDivisor &divisor, const SCALE &scale) {
+	int64_t scaled_a;
+	if (__builtin_expect(scale.pow10_64 != 0 && !__builtin_mul_overflow(a, scale.pow10_64, &scaled_a), 1)) {
+		return SparkDecimalDivide64Constant(scaled_a, divisor);
+	}
+	return SparkDecimalDivideConstant(a, divisor, scale.pow10_val, scale.pow10_extra);
+}
+
+// ---------------------------------------------------------------------------
+// Comparing a quotient without computing it
+// ---------------------------------------------------------------------------
+// q = SparkDecimalDivide(a, b, 10^scale_adj) rounds halves away from zero, so
+// for an integer t >= 1
+//   |q| >= t  <=>  |a| * 10^scale_adj / |b| >= t - 1/2
+//            <=>  2 * |a| * 10^scale_adj >= (2t - 1) * |b|
+// Deciding q against a bound is then two multiplications and a compare
+// instead of the 128- or 256-bit division. b must be non-zero.
+
+// Any operands: 256-bit products. 2 * |a| < 2^128, so the left side is one Mul128.
+struct SparkQuotientWide {
+	uint256_t twice_scaled;
+	unsigned __int128 abs_b;
+	bool negative;
+
+	SparkQuotientWide(__int128 a, __int128 b, unsigned __int128 pow10)
+	    : twice_scaled(Mul128(Abs128(a) * 2, pow10)), abs_b(Abs128(b)), negative((a < 0) != (b < 0)) {
+	}
+
+	// |q| >= t, with factor = 2t - 1 < 2^128
+	bool MagnitudeAtLeast(unsigned __int128 factor) const {
+		return !LessThan256(twice_scaled, Mul128(factor, abs_b));
+	}
+};
+
+// Operands stored in int64_t with |a| * 10^scale_adj < 2^63 (p1 + scale_adj <= 18):
+// the left side is below 2^64 and the right side fits in 128 bits when it can
+// still be smaller.
+struct SparkQuotientNarrow {
+	unsigned __int128 twice_scaled;
+	unsigned __int128 abs_b;
+	bool negative;
+
+	SparkQuotientNarrow(int64_t a, int64_t b, int64_t pow10_64)
+	    : twice_scaled(Abs128(a) * static_cast<uint64_t>(pow10_64) * 2), abs_b(Abs128(b)),
+	      negative((a < 0) != (b < 0)) {
+	}
+
+	bool MagnitudeAtLeast(unsigned __int128 factor) const {
+		// factor >= 2^64 puts the right side above 2^64 > twice_scaled
+		return (factor >> 64) == 0 && twice_scaled >= factor * abs_b;
+	}
+};
+
+// scale_adj above 38: 2 |a| 10^scale_adj can exceed 256 bits, so the quotient
+// is computed after all. A quotient beyond 128 bits saturates to 10^38, which is
+// at least every bound compared against.
+struct SparkQuotientComputed {
+	unsigned __int128 magnitude;
+	bool negative;
+
+	SparkQuotientComputed(__int128 a, __int128 b, const SparkDivScale &scale) {
+		__int128 q = SparkDecimalDivide(a, b, scale.pow10_val, scale.pow10_extra);
+		magnitude = Abs128(q);
+		negative = q < 0;
+	}
+
+	// |q| >= t  <=>  2 |q| > 2t - 1
+	bool MagnitudeAtLeast(unsigned __int128 factor) const {
+		return magnitude * 2 > factor;
+	}
+};
+
+// |q| >= t
+template <typename QUOTIENT>
+inline bool SparkQuotientMagnitudeAtLeast(const QUOTIENT &q, unsigned __int128 t) {
+	return q.MagnitudeAtLeast(t * 2 - 1);
+}
+
+// q >= c, for |c| <= 10^38
+template <typename QUOTIENT>
+inline bool SparkQuotientAtLeast(const QUOTIENT &q, __int128 c) {
+	if (!q.negative) {
+		// q >= 0: always when c <= 0, otherwise |q| >= c
+		return c <= 0 || SparkQuotientMagnitudeAtLeast(q, static_cast<unsigned __int128>(c));
+	}
+	// q <= 0: never when c > 0, otherwise |q| <= -c, i.e. not |q| >= 1 - c
+	return c <= 0 && !SparkQuotientMagnitudeAtLeast(q, Abs128(c) + 1);
 }
 
 } // namespace duckdb
@@ -3,10 +3,21 @@
 #include "duckdb.hpp"
 #include "duckdb/function/aggregate_function.hpp"
 #include "duckdb/function/aggregate_state.hpp"
+#include "duckdb/common/types/column/column_data_collection.hpp"
 #include "duckdb/common/types/decimal.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/planner/expression/bound_aggregate_expression.hpp"
+#include "duckdb/storage/statistics/node_statistics.hpp"
 #include "spark_precision.hpp"
+#include "spark_statistics.hpp"
+#include "spark_counters.hpp"
+#include "spark_ansi.hpp"
 #include "wide_integer.hpp"
 #include "decimal_division.hpp"
+#include "spark_hash.hpp"
+#include "spark_sketch.hpp"
+
+#include <cmath>
 
 namespace duckdb {
 
@@ -16,19 +27,23 @@ namespace duckdb {
 
 struct SparkAggBindData : public FunctionData {
 	uint8_t input_scale;
+	uint8_t result_precision;
 	uint8_t result_scale;
+	bool ansi; // overflow of the result precision raises an error instead of returning NULL
 
-	SparkAggBindData(uint8_t input_scale_p, uint8_t result_scale_p)
-	    : input_scale(input_scale_p), result_scale(result_scale_p) {
+	SparkAggBindData(uint8_t input_scale_p, const SparkDecimalResult &result_p, bool ansi_p)
+	    : input_scale(input_scale_p), result_precision(result_p.precision), result_scale(result_p.scale),
+	      ansi(ansi_p) {
 	}
 
 	unique_ptr<FunctionData> Copy() const override {
-		return make_uniq<SparkAggBindData>(input_scale, result_scale);
+		return make_uniq<SparkAggBindData>(input_scale, SparkDecimalResult {result_precision, result_scale}, ansi);
 	}
 
 	bool Equals(const FunctionData &other_p) const override {
 		auto &other = other_p.Cast<SparkAggBindData>();
-		return input_scale == other.input_scale && result_scale == other.result_scale;
+		return input_scale == other.input_scale && result_precision == other.result_precision &&
+		       result_scale == other.result_scale && ansi == other.ansi;
 	}
 };
 
@@ -46,11 +61,366 @@ inline void WriteAggResult<hugeint_t>(hugeint_t &target, __int128 val) {
 	target = Int128ToHugeint(val);
 }
 
+// Finalize-time write with the Spark overflow check: a result outside the
+// result precision is NULL, or an error in ANSI mode. Runs once per group, so
+// a plain compare is enough here.
+template <typename T>
+static inline void WriteAggResultChecked(T &target, __int128 val, AggregateFinalizeData &finalize_data) {
+	auto &bind_data = finalize_data.input.bind_data->Cast<SparkAggBindData>();
+	if (__builtin_expect(Abs128(val) >= Pow10_128(bind_data.result_precision), 0)) {
+		if (bind_data.ansi) {
+			ThrowSparkDecimalOverflow(LogicalType::DECIMAL(bind_data.result_precision, bind_data.result_scale));
+		}
+		finalize_data.ReturnNull();
+		return;
+	}
+	WriteAggResult(target, val);
+}
+
+// ============================================================================
+// Helper: install a width-specialized implementation into a bound function
+//
+// The DECIMAL overloads are registered with a hugeint_t template; bind picks
+// the implementation matching the input and result physical types and copies
+// its callbacks (including state_size, since the state layout differs).
+// ============================================================================
+
+static inline void SetSparkAggregateImplementation(AggregateFunction &function, const AggregateFunction &impl) {
+	function.state_size = impl.state_size;
+	function.initialize = impl.initialize;
+	function.update = impl.update;
+	function.combine = impl.combine;
+	function.finalize = impl.finalize;
+	function.simple_update = impl.simple_update;
+	function.window = impl.window;
+	function.window_init = impl.window_init;
+	function.destructor = impl.destructor;
+}
+
+// ============================================================================
+// Helper: 64-bit accumulator with overflow counter
+//
+// DECIMAL(p <= 18) values fit in int64, so one addition wraps at most once.
+// The wrap is recorded in a signed counter in units of 2^64; the exact sum is
+// overflow * 2^64 + value. The common case is a single add plus a
+// never-taken branch on the overflow flag.
+// ============================================================================
+
+struct SparkNarrowAccumulator {
+	static inline void Add(int64_t &value, int32_t &overflow, int64_t input) {
+		if (__builtin_expect(__builtin_add_overflow(value, input, &value), 0)) {
+			overflow += input < 0 ? -1 : 1;
+		}
+	}
+
+	static inline __int128 Get(int64_t value, int32_t overflow) {
+		return static_cast<__int128>(overflow) * (static_cast<__int128>(1) << 64) + value;
+	}
+
+	static inline void Set(int64_t &value, int32_t &overflow, __int128 total) {
+		value = static_cast<int64_t>(static_cast<uint64_t>(total));
+		overflow = static_cast<int32_t>((total - value) >> 64);
+	}
+
+	static inline void AddWide(int64_t &value, int32_t &overflow, __int128 input) {
+		Set(value, overflow, Get(value, overflow) + input);
+	}
+};
+
+// ============================================================================
+// Helper: checked native 128-bit add into a hugeint_t state
+//
+// Same overflow behavior as hugeint_t's operator+=, but inlined as a single
+// add/adc pair instead of an out-of-line call per row.
+// ============================================================================
+
+static inline void SparkAddHugeintChecked(hugeint_t &target, __int128 input) {
+	__int128 result;
+	if (__builtin_expect(__builtin_add_overflow(HugeintToInt128(target), input, &result), 0)) {
+		throw OutOfRangeException("Overflow in HUGEINT addition");
+	}
+	target = Int128ToHugeint(result);
+}
+
+// ============================================================================
+// Helper: per-vector block sums
+//
+// simple_update sums a whole vector locally and folds the total into the
+// state once. Narrow inputs sum into a native __int128, which cannot overflow
+// for one vector of int64 values. hugeint_t inputs use a carry-save pair:
+// unsigned lower halves and signed upper halves are summed separately (192
+// bits of headroom), and the carry is resolved once in Total().
+// ============================================================================
+
+template <typename INPUT_TYPE>
+struct SparkBlockSum {
+	__int128 sum = 0;
+
+	void Add(const INPUT_TYPE &input) {
+		sum += input;
+	}
+
+	void AddConstant(const INPUT_TYPE &input, idx_t count) {
+		sum += static_cast<__int128>(input) * static_cast<__int128>(count);
+	}
+
+	__int128 Total() const {
+		return sum;
+	}
+};
+
+template <>
+struct SparkBlockSum<hugeint_t> {
+	unsigned __int128 lower_sum = 0;
+	__int128 upper_sum = 0;
+
+	void Add(const hugeint_t &input) {
+		lower_sum += input.lower;
+		upper_sum += input.upper;
+	}
+
+	void AddConstant(const hugeint_t &input, idx_t count) {
+		lower_sum += static_cast<unsigned __int128>(input.lower) * count;
+		upper_sum += static_cast<__int128>(input.upper) * static_cast<__int128>(count);
+	}
+
+	__int128 Total() const {
+		__int128 upper = upper_sum + static_cast<__int128>(lower_sum >> 64);
+		if (upper > NumericLimits<int64_t>::Maximum() || upper < NumericLimits<int64_t>::Minimum()) {
+			throw OutOfRangeException("Overflow in HUGEINT addition");
+		}
+		return static_cast<__int128>((static_cast<unsigned __int128>(upper) << 64) | static_cast<uint64_t>(lower_sum));
+	}
+};
+
+// simple_update for the DECIMAL sum/avg states: STATE must provide
+// AddBlock(__int128 total, idx_t valid_count).
+template <class STATE, class INPUT_TYPE>
+static void SparkDecimalBlockSimpleUpdate(Vector inputs[], AggregateInputData &, idx_t input_count,
+                                          data_ptr_t state_p, idx_t count) {
+	D_ASSERT(input_count == 1);
+	SparkCountAdd(STATE::ROW_COUNTER, count);
+	auto &state = *reinterpret_cast<STATE *>(state_p);
+	auto &input = inputs[0];
+
+	SparkBlockSum<INPUT_TYPE> block;
+	idx_t valid_count = 0;
+	switch (input.GetVectorType()) {
+	case VectorType::CONSTANT_VECTOR: {
+		if (ConstantVector::IsNull(input)) {
+			return;
+		}
+		block.AddConstant(*ConstantVector::GetData<INPUT_TYPE>(input), count);
+		valid_count = count;
+		break;
+	}
+	case VectorType::FLAT_VECTOR: {
+		auto data = FlatVector::GetData<INPUT_TYPE>(input);
+		auto &mask = FlatVector::Validity(input);
+		if (mask.AllValid()) {
+			for (idx_t i = 0; i < count; i++) {
+				block.Add(data[i]);
+			}
+			valid_count = count;
+			break;
+		}
+		idx_t base_idx = 0;
+		auto entry_count = ValidityMask::EntryCount(count);
+		for (idx_t entry_idx = 0; entry_idx < entry_count; entry_idx++) {
+			auto validity_entry = mask.GetValidityEntry(entry_idx);
+			idx_t next = MinValue<idx_t>(base_idx + ValidityMask::BITS_PER_VALUE, count);
+			if (ValidityMask::AllValid(validity_entry)) {
+				valid_count += next - base_idx;
+				for (; base_idx < next; base_idx++) {
+					block.Add(data[base_idx]);
+				}
+			} else if (ValidityMask::NoneValid(validity_entry)) {
+				base_idx = next;
+			} else {
+				idx_t start = base_idx;
+				for (; base_idx < next; base_idx++) {
+					if (ValidityMask::RowIsValid(validity_entry, base_idx - start)) {
+						block.Add(data[base_idx]);
+						valid_count++;
+					}
+				}
+			}
+		}
+		break;
+	}
+	default: {
+		UnifiedVectorFormat fmt;
+		input.ToUnifiedFormat(count, fmt);
+		auto data = UnifiedVectorFormat::GetData<INPUT_TYPE>(fmt);
+		for (idx_t i = 0; i < count; i++) {
+			auto idx = fmt.sel->get_index(i);
+			if (fmt.validity.RowIsValid(idx)) {
+				block.Add(data[idx]);
+				valid_count++;
+			}
+		}
+		break;
+	}
+	}
+	if (valid_count > 0) {
+		state.AddBlock(block.Total(), valid_count);
+	}
+}
+
+// Grouped update for the DECIMAL sum/avg states: DuckDB's scatter loop, plus
+// the per-vector row counter.
+template <class STATE, class INPUT_TYPE, class OP>
+static void SparkDecimalScatterUpdate(Vector inputs[], AggregateInputData &aggr_input_data, idx_t input_count,
+                                      Vector &states, idx_t count) {
+	SparkCountAdd(STATE::ROW_COUNTER, count);
+	AggregateFunction::UnaryScatterUpdate<STATE, INPUT_TYPE, OP>(inputs, aggr_input_data, input_count, states,
+	                                                             count);
+}
+
+// ============================================================================
+// Window support: prefix sums over the partition
+//
+// window_init scans the partition once and builds prefix sums of the valid
+// (and FILTER-passing) values and their counts. Any frame -- ROWS, RANGE or
+// GROUPS, moving or not, split into several subframes by EXCLUDE -- is then
+// answered with two lookups per subframe, so no inverse operation is needed.
+//
+// Prefix sums are 192-bit so that they cannot overflow for hugeint_t inputs;
+// a frame total outside the 128-bit range raises, as in the grouped path.
+// The frame total is loaded into the local state with AddBlock and finalized
+// by the operation's own Finalize, so results match the grouped path exactly.
+// ============================================================================
+
+struct SparkWindowSum {
+	uint64_t lo = 0;
+	uint64_t mid = 0;
+	int64_t hi = 0;
+
+	unsigned __int128 Low() const {
+		return (static_cast<unsigned __int128>(mid) << 64) | lo;
+	}
+
+	void SetLow(unsigned __int128 low) {
+		lo = static_cast<uint64_t>(low);
+		mid = static_cast<uint64_t>(low >> 64);
+	}
+
+	void Add(__int128 input) {
+		unsigned __int128 low = Low();
+		unsigned __int128 sum = low + static_cast<unsigned __int128>(input);
+		hi += static_cast<int64_t>(sum < low) - static_cast<int64_t>(input < 0);
+		SetLow(sum);
+	}
+
+	void Add(const SparkWindowSum &other) {
+		unsigned __int128 low = Low();
+		unsigned __int128 sum = low + other.Low();
+		hi += other.hi + static_cast<int64_t>(sum < low);
+		SetLow(sum);
+	}
+
+	void Subtract(const SparkWindowSum &other) {
+		unsigned __int128 low = Low();
+		unsigned __int128 diff = low - other.Low();
+		hi -= other.hi + static_cast<int64_t>(low < other.Low());
+		SetLow(diff);
+	}
+
+	__int128 ToInt128() const {
+		__int128 low = static_cast<__int128>(Low());
+		if (hi != (low < 0 ? -1 : 0)) {
+			throw OutOfRangeException("Overflow in HUGEINT addition");
+		}
+		return low;
+	}
+};
+
+struct SparkWindowPrefix {
+	//! partition.count + 1 entries: sums[i] covers rows [0, i)
+	SparkWindowSum *sums;
+	uint64_t *counts;
+};
+
+// The window executor passes the same global state (state_size bytes) to
+// window_init and window. It is not used as an accumulator in window mode, so
+// it holds the pointer to the arena-allocated prefix sums instead.
+template <class STATE, class INPUT_TYPE>
+static void SparkDecimalWindowInit(AggregateInputData &aggr_input_data, const WindowPartitionInput &partition,
+                                   data_ptr_t g_state) {
+	static_assert(sizeof(STATE) >= sizeof(SparkWindowPrefix *), "window prefix pointer must fit in the state");
+	auto &allocator = aggr_input_data.allocator;
+	const idx_t count = partition.count;
+
+	auto prefix = reinterpret_cast<SparkWindowPrefix *>(allocator.AllocateAligned(sizeof(SparkWindowPrefix)));
+	prefix->sums = reinterpret_cast<SparkWindowSum *>(allocator.AllocateAligned((count + 1) * sizeof(SparkWindowSum)));
+	prefix->counts = reinterpret_cast<uint64_t *>(allocator.AllocateAligned((count + 1) * sizeof(uint64_t)));
+
+	SparkWindowSum running;
+	uint64_t running_count = 0;
+	prefix->sums[0] = running;
+	prefix->counts[0] = 0;
+
+	if (count > 0 && partition.inputs) {
+		auto &inputs = *partition.inputs;
+		const auto &filter_mask = partition.filter_mask;
+		ColumnDataScanState scan;
+		DataChunk chunk;
+		inputs.InitializeScan(scan, partition.column_ids);
+		inputs.InitializeScanChunk(scan, chunk);
+
+		idx_t row = 0;
+		while (inputs.Scan(scan, chunk)) {
+			UnifiedVectorFormat fmt;
+			chunk.data[0].ToUnifiedFormat(chunk.size(), fmt);
+			auto data = UnifiedVectorFormat::GetData<INPUT_TYPE>(fmt);
+			for (idx_t i = 0; i < chunk.size(); i++, row++) {
+				auto idx = fmt.sel->get_index(i);
+				if (fmt.validity.RowIsValid(idx) && filter_mask.RowIsValid(row)) {
+					running.Add(DecimalToInt128(data[idx]));
+					running_count++;
+				}
+				prefix->sums[row + 1] = running;
+				prefix->counts[row + 1] = running_count;
+			}
+		}
+		D_ASSERT(row == count);
+	}
+
+	*reinterpret_cast<SparkWindowPrefix **>(g_state) = prefix;
+}
+
+template <class STATE, class RESULT_TYPE, class OP>
+static void SparkDecimalWindow(AggregateInputData &aggr_input_data, const WindowPartitionInput &partition,
+                               const_data_ptr_t g_state, data_ptr_t l_state, const SubFrames &frames, Vector &result,
+                               idx_t rid) {
+	auto &prefix = **reinterpret_cast<SparkWindowPrefix *const *>(g_state);
+
+	SparkWindowSum frame_sum;
+	uint64_t frame_count = 0;
+	for (const auto &frame : frames) {
+		frame_sum.Add(prefix.sums[frame.end]);
+		frame_sum.Subtract(prefix.sums[frame.start]);
+		frame_count += prefix.counts[frame.end] - prefix.counts[frame.start];
+	}
+
+	auto &state = *reinterpret_cast<STATE *>(l_state);
+	state.Initialize();
+	if (frame_count > 0) {
+		state.AddBlock(frame_sum.ToInt128(), frame_count);
+	}
+
+	AggregateFinalizeData finalize_data(result, aggr_input_data);
+	finalize_data.result_idx = rid;
+	auto result_data = FlatVector::GetData<RESULT_TYPE>(result);
+	OP::template Finalize<RESULT_TYPE, STATE>(state, result_data[rid], finalize_data);
+}
+
 // ============================================================================
 // spark_sum: DECIMAL path
 //
-// Accumulates values into hugeint_t (scaled integers).
-// Input is promoted to DECIMAL(38, s) by DuckDB's implicit cast.
+// Accumulates scaled integers in the input's native width:
+//   p <= 18 -> SparkSumDecimalNarrowState (int64 + overflow counter, 16 bytes)
+//   p >  18 -> SparkSumDecimalState (hugeint_t, 24 bytes)
 // Returns DECIMAL(min(p+10, 38), s) per Spark rules.
 // ============================================================================
 
@@ -58,17 +428,95 @@ struct SparkSumDecimalState {
 	hugeint_t value;
 	bool isset;
 
+	static constexpr SparkCounter ROW_COUNTER = SparkCounter::AGG_WIDE_ROWS;
+
 	void Initialize() {
 		isset = false;
 		value = hugeint_t(0);
 	}
 
+	void Add(const hugeint_t &input) {
+		SparkAddHugeintChecked(value, HugeintToInt128(input));
+	}
+
+	void AddConstant(const hugeint_t &input, idx_t count) {
+		value += input * Hugeint::Convert(static_cast<int64_t>(count));
+	}
+
+	void AddBlock(__int128 total, idx_t) {
+		isset = true;
+		SparkAddHugeintChecked(value, total);
+	}
+
 	void Combine(const SparkSumDecimalState &other) {
 		if (other.isset) {
 			isset = true;
-			value += other.value;
+			SparkAddHugeintChecked(value, HugeintToInt128(other.value));
+		}
+	}
+
+	__int128 Value() const {
+		return HugeintToInt128(value);
+	}
+};
+
+struct SparkSumDecimalNarrowState {
+	int64_t value;
+	int32_t overflow;
+	bool isset;
+
+	static constexpr SparkCounter ROW_COUNTER = SparkCounter::AGG_NARROW_ROWS;
+
+	void Initialize() {
+		isset = false;
+		value = 0;
+		overflow = 0;
+	}
+
+	void Add(int64_t input) {
+		SparkNarrowAccumulator::Add(value, overflow, input);
+	}
+
+	// hugeint_t input whose statistics prove that it fits in int64 (see SparkSumDecimalStats)
+	void Add(const hugeint_t &input) {
+		Add(static_cast<int64_t>(input.lower));
+	}
+
+	void AddConstant(int64_t input, idx_t count) {
+		SparkNarrowAccumulator::AddWide(value, overflow, static_cast<__int128>(input) * static_cast<__int128>(count));
+	}
+
+	void AddConstant(const hugeint_t &input, idx_t count) {
+		AddConstant(static_cast<int64_t>(input.lower), count);
+	}
+
+	void AddBlock(__int128 total, idx_t) {
+		isset = true;
+		SparkNarrowAccumulator::AddWide(value, overflow, total);
+	}
+
+	void Combine(const SparkSumDecimalNarrowState &other) {
+		if (other.isset) {
+			isset = true;
+			SparkNarrowAccumulator::Add(value, overflow, other.value);
+			overflow += other.overflow;
 		}
 	}
+
+	__int128 Value() const {
+		return SparkNarrowAccumulator::Get(value, overflow);
+	}
+};
+
+// State selection by input physical type
+template <typename INPUT_TYPE>
+struct SparkSumDecimalStateFor {
+	using type = SparkSumDecimalNarrowState;
+};
+
+template <>
+struct SparkSumDecimalStateFor<hugeint_t> {
+	using type = SparkSumDecimalState;
 };
 
 // Templatized operation so Finalize can target different physical types
@@ -82,13 +530,13 @@ struct SparkSumDecimalOperation {
 	template <class INPUT_TYPE, class STATE, class OP>
 	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &) {
 		state.isset = true;
-		state.value += hugeint_t(input);
+		state.Add(input);
 	}
 
 	template <class INPUT_TYPE, class STATE, class OP>
 	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &, idx_t count) {
 		state.isset = true;
-		state.value += hugeint_t(input) * Hugeint::Convert(static_cast<int64_t>(count));
+		state.AddConstant(input, count);
 	}
 
 	template <class STATE, class OP>
@@ -101,8 +549,7 @@ struct SparkSumDecimalOperation {
 		if (!state.isset) {
 			finalize_data.ReturnNull();
 		} else {
-			__int128 val = HugeintToInt128(state.value);
-			WriteAggResult(target, val);
+			WriteAggResultChecked(target, state.Value(), finalize_data);
 		}
 	}
 
@@ -111,12 +558,60 @@ struct SparkSumDecimalOperation {
 	}
 };
 
-// Helper: create a SparkSumDecimal AggregateFunction for a specific result physical type
-template <typename RESULT_TYPE>
+// Helper: create a SparkSumDecimal AggregateFunction for specific input/result physical types
+template <typename INPUT_TYPE, typename RESULT_TYPE,
+          typename STATE = typename SparkSumDecimalStateFor<INPUT_TYPE>::type>
 static AggregateFunction GetSparkSumDecimalFunction() {
-	return AggregateFunction::UnaryAggregate<SparkSumDecimalState, hugeint_t, RESULT_TYPE,
-	                                          SparkSumDecimalOperation<RESULT_TYPE>>(
-	    LogicalType::DECIMAL(38, 0), LogicalType::DECIMAL(38, 0));
+	auto function =
+	    AggregateFunction::UnaryAggregate<STATE, INPUT_TYPE, RESULT_TYPE, SparkSumDecimalOperation<RESULT_TYPE>>(
+	        LogicalType::DECIMAL(38, 0), LogicalType::DECIMAL(38, 0));
+	function.update = SparkDecimalScatterUpdate<STATE, INPUT_TYPE, SparkSumDecimalOperation<RESULT_TYPE>>;
+	// Ungrouped aggregation: sum each vector locally, fold into the state once
+	function.simple_update = SparkDecimalBlockSimpleUpdate<STATE, INPUT_TYPE>;
+	// Window frames: prefix sums over the partition
+	function.window_init = SparkDecimalWindowInit<STATE, INPUT_TYPE>;
+	function.window = SparkDecimalWindow<STATE, RESULT_TYPE, SparkSumDecimalOperation<RESULT_TYPE>>;
+	return function;
+}
+
+template <typename INPUT_TYPE>
+static AggregateFunction GetSparkSumDecimalFunction(PhysicalType result_type) {
+	switch (result_type) {
+	case PhysicalType::INT16:
+		return GetSparkSumDecimalFunction<INPUT_TYPE, int16_t>();
+	case PhysicalType::INT32:
+		return GetSparkSumDecimalFunction<INPUT_TYPE, int32_t>();
+	case PhysicalType::INT64:
+		return GetSparkSumDecimalFunction<INPUT_TYPE, int64_t>();
+	case PhysicalType::INT128:
+		return GetSparkSumDecimalFunction<INPUT_TYPE, hugeint_t>();
+	default:
+		throw InternalException("Unexpected physical type for spark_sum DECIMAL result");
+	}
+}
+
+static AggregateFunction GetSparkSumDecimalFunction(PhysicalType input_type, PhysicalType result_type) {
+	switch (input_type) {
+	case PhysicalType::INT16:
+		return GetSparkSumDecimalFunction<int16_t>(result_type);
+	case PhysicalType::INT32:
+		return GetSparkSumDecimalFunction<int32_t>(result_type);
+	case PhysicalType::INT64:
+		return GetSparkSumDecimalFunction<int64_t>(result_type);
+	case PhysicalType::INT128:
+		return GetSparkSumDecimalFunction<hugeint_t>(result_type);
+	default:
+		throw InternalException("Unexpected physical type for spark_sum DECIMAL input");
+	}
+}
+
+// hugeint_t input accumulated in the 64-bit state (values proven to fit by statistics).
+// p > 18 always yields a hugeint_t result.
+static AggregateFunction GetSparkSumDecimalNarrowedFunction(PhysicalType result_type) {
+	if (result_type != PhysicalType::INT128) {
+		throw InternalException("Unexpected physical type for spark_sum DECIMAL result");
+	}
+	return GetSparkSumDecimalFunction<hugeint_t, hugeint_t, SparkSumDecimalNarrowState>();
 }
 
 static unique_ptr<FunctionData> BindSparkSumDecimal(ClientContext &context, AggregateFunction &function,
@@ -129,59 +624,85 @@ static unique_ptr<FunctionData> BindSparkSumDecimal(ClientContext &context, Aggr
 	uint8_t p = DecimalType::GetWidth(type);
 	uint8_t s = DecimalType::GetScale(type);
 	auto result = ComputeSumType(p, s);
-
-	// Promote input to DECIMAL(38, s) -> hugeint_t physical type
-	function.arguments[0] = LogicalType::DECIMAL(38, s);
 	auto result_type = LogicalType::DECIMAL(result.precision, result.scale);
+
+	// Take the input in its native width (no cast) and select the state and
+	// finalize implementation for the input and result physical types.
+	SetSparkAggregateImplementation(function,
+	                                GetSparkSumDecimalFunction(type.InternalType(), result_type.InternalType()));
+	function.arguments[0] = type;
 	function.return_type = result_type;
 
-	// Select the correct function implementation based on result physical type
-	// The finalize function must write to the correct physical type for the result DECIMAL.
-	{
-		AggregateFunction tf = [&]() -> AggregateFunction {
-			switch (result_type.InternalType()) {
-			case PhysicalType::INT16:
-				return GetSparkSumDecimalFunction<int16_t>();
-			case PhysicalType::INT32:
-				return GetSparkSumDecimalFunction<int32_t>();
-			case PhysicalType::INT64:
-				return GetSparkSumDecimalFunction<int64_t>();
-			case PhysicalType::INT128:
-				return GetSparkSumDecimalFunction<hugeint_t>();
-			default:
-				throw InternalException("Unexpected physical type for spark_sum DECIMAL result");
-			}
-		}();
-		function.update = tf.update;
-		function.combine = tf.combine;
-		function.finalize = tf.finalize;
-		function.simple_update = tf.simple_update;
+	return make_uniq<SparkAggBindData>(s, result, SparkAnsiEnabled(context));
+}
+
+// Statistics of a spark_sum result of type result_type over input values in
+// [min_val, max_val]: with a known maximum cardinality n the sum is bounded by
+// [min * n, max * n]. nullptr when unknown or outside the result precision.
+static unique_ptr<BaseStatistics> SparkSumDecimalResultStats(const LogicalType &result_type, __int128 min_val,
+                                                             __int128 max_val, AggregateStatisticsInput &input) {
+	if (!input.node_stats || !input.node_stats->has_max_cardinality) {
+		return nullptr;
+	}
+	auto max_cardinality = input.node_stats->max_cardinality;
+	if (max_cardinality > static_cast<idx_t>(NumericLimits<int64_t>::Maximum())) {
+		return nullptr;
 	}
+	auto n = static_cast<__int128>(max_cardinality);
+	__int128 sum_min = min_val;
+	__int128 sum_max = max_val;
+	if ((min_val < 0 && __builtin_mul_overflow(min_val, n, &sum_min)) ||
+	    (max_val > 0 && __builtin_mul_overflow(max_val, n, &sum_max))) {
+		return nullptr;
+	}
+	auto width = DecimalType::GetWidth(result_type);
+	if (!FitsDecimalWidth(sum_min, width) || !FitsDecimalWidth(sum_max, width)) {
+		return nullptr;
+	}
+	// Empty groups and all-NULL groups produce NULL
+	return MakeDecimalStats(result_type, sum_min, sum_max, true);
+}
 
-	return make_uniq<SparkAggBindData>(s, result.scale);
+// Statistics: a hugeint_t input whose values fit in int64 switches to the
+// 64-bit state (as a DECIMAL(p <= 18) input would use).
+static unique_ptr<BaseStatistics> SparkSumDecimalStats(ClientContext &context, BoundAggregateExpression &expr,
+                                                       AggregateStatisticsInput &input) {
+	__int128 min_val, max_val;
+	if (!TryGetDecimalStatsBounds(input.child_stats[0], min_val, max_val)) {
+		return nullptr;
+	}
+	auto result_physical = expr.function.return_type.InternalType();
+	if (expr.children[0]->return_type.InternalType() == PhysicalType::INT128 && BoundsFitInt64(min_val, max_val)) {
+		SetSparkAggregateImplementation(expr.function, GetSparkSumDecimalNarrowedFunction(result_physical));
+	}
+	return SparkSumDecimalResultStats(expr.return_type, min_val, max_val, input);
 }
 
 // ============================================================================
 // spark_sum: Integer path
 //
 // Spark: SUM(int/long/short/byte) -> BIGINT
-// Accumulates into int64_t, returns BIGINT.
+// Accumulates into SparkSumIntegerState (int64 + overflow counter), so
+// the exact sum is known however often the 64-bit value wraps; ungrouped input
+// is summed a vector at a time in an __int128 block and folded in once. A sum
+// outside the BIGINT range wraps around like Spark's long addition, or raises
+// ARITHMETIC_OVERFLOW in ANSI mode. Spark raises as soon as a running sum
+// overflows; here the exact total is checked, so whether a query fails does
+// not depend on the order in which rows are added.
 // ============================================================================
 
-struct SparkSumIntegerState {
-	int64_t value;
-	bool isset;
+struct SparkSumIntegerBindData : public FunctionData {
+	bool ansi; // overflow raises an error instead of wrapping around
 
-	void Initialize() {
-		isset = false;
-		value = 0;
+	explicit SparkSumIntegerBindData(bool ansi_p) : ansi(ansi_p) {
 	}
 
-	void Combine(const SparkSumIntegerState &other) {
-		if (other.isset) {
-			isset = true;
-			value += other.value;
-		}
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<SparkSumIntegerBindData>(ansi);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		return ansi == other_p.Cast<SparkSumIntegerBindData>().ansi;
 	}
 };
 
@@ -194,13 +715,13 @@ struct SparkSumIntegerOperation {
 	template <class INPUT_TYPE, class STATE, class OP>
 	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &) {
 		state.isset = true;
-		state.value += static_cast<int64_t>(input);
+		state.Add(static_cast<int64_t>(input));
 	}
 
 	template <class INPUT_TYPE, class STATE, class OP>
 	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &, idx_t count) {
 		state.isset = true;
-		state.value += static_cast<int64_t>(input) * static_cast<int64_t>(count);
+		state.AddConstant(static_cast<int64_t>(input), count);
 	}
 
 	template <class STATE, class OP>
@@ -212,9 +733,16 @@ struct SparkSumIntegerOperation {
 	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
 		if (!state.isset) {
 			finalize_data.ReturnNull();
-		} else {
-			target = state.value;
+			return;
+		}
+		auto total = state.Value();
+		if (__builtin_expect(total < NumericLimits<int64_t>::Minimum() || total > NumericLimits<int64_t>::Maximum(),
+		                     0)) {
+			if (finalize_data.input.bind_data->Cast<SparkSumIntegerBindData>().ansi) {
+				ThrowSparkLongOverflow();
+			}
 		}
+		target = static_cast<int64_t>(static_cast<uint64_t>(total));
 	}
 
 	static bool IgnoreNull() {
@@ -222,11 +750,38 @@ struct SparkSumIntegerOperation {
 	}
 };
 
+// The DECIMAL(p <= 18) state, counted apart from the DECIMAL sums
+struct SparkSumIntegerState : public SparkSumDecimalNarrowState {
+	static constexpr SparkCounter ROW_COUNTER = SparkCounter::AGG_INTEGER_ROWS;
+};
+
+static unique_ptr<FunctionData> BindSparkSumInteger(ClientContext &context, AggregateFunction &,
+                                                     vector<unique_ptr<Expression>> &) {
+	return make_uniq<SparkSumIntegerBindData>(SparkAnsiEnabled(context));
+}
+
+// Same update, simple_update and window callbacks as the DECIMAL(p <= 18) sum
+template <typename INPUT_TYPE>
+static AggregateFunction GetSparkSumIntegerFunction(const LogicalType &input_type) {
+	typedef SparkSumIntegerState STATE;
+	auto function = AggregateFunction::UnaryAggregate<STATE, INPUT_TYPE, int64_t, SparkSumIntegerOperation>(
+	    input_type, LogicalType::BIGINT);
+	function.update = SparkDecimalScatterUpdate<STATE, INPUT_TYPE, SparkSumIntegerOperation>;
+	function.simple_update = SparkDecimalBlockSimpleUpdate<STATE, INPUT_TYPE>;
+	function.window_init = SparkDecimalWindowInit<STATE, INPUT_TYPE>;
+	function.window = SparkDecimalWindow<STATE, int64_t, SparkSumIntegerOperation>;
+	function.bind = BindSparkSumInteger;
+	function.order_dependent = AggregateOrderDependent::NOT_ORDER_DEPENDENT;
+	return function;
+}
+
 // ============================================================================
 // spark_avg: DECIMAL path
 //
-// Accumulates sum (hugeint_t) and count (uint64_t).
-// At finalize, divides sum/count using SparkDecimalDivide with ROUND_HALF_UP.
+// Accumulates sum and count (uint64_t); the sum is kept in the input's native
+// width as for spark_sum (int64 + overflow counter for p <= 18, hugeint_t
+// otherwise). At finalize, divides sum/count using SparkDecimalDivide with
+// ROUND_HALF_UP.
 // Returns DECIMAL(min(p+4, 38), min(s+4, 18)) per Spark rules.
 // ============================================================================
 
@@ -234,17 +789,92 @@ struct SparkAvgDecimalState {
 	hugeint_t sum;
 	uint64_t count;
 
+	static constexpr SparkCounter ROW_COUNTER = SparkCounter::AGG_WIDE_ROWS;
+
 	void Initialize() {
 		count = 0;
 		sum = hugeint_t(0);
 	}
 
+	void Add(const hugeint_t &input) {
+		SparkAddHugeintChecked(sum, HugeintToInt128(input));
+	}
+
+	void AddConstant(const hugeint_t &input, idx_t count_p) {
+		sum += input * Hugeint::Convert(static_cast<int64_t>(count_p));
+	}
+
+	void AddBlock(__int128 total, idx_t valid_count) {
+		count += valid_count;
+		SparkAddHugeintChecked(sum, total);
+	}
+
 	void Combine(const SparkAvgDecimalState &other) {
 		count += other.count;
-		sum += other.sum;
+		SparkAddHugeintChecked(sum, HugeintToInt128(other.sum));
+	}
+
+	__int128 Sum() const {
+		return HugeintToInt128(sum);
+	}
+};
+
+struct SparkAvgDecimalNarrowState {
+	int64_t sum;
+	int32_t overflow;
+	uint64_t count;
+
+	static constexpr SparkCounter ROW_COUNTER = SparkCounter::AGG_NARROW_ROWS;
+
+	void Initialize() {
+		count = 0;
+		sum = 0;
+		overflow = 0;
+	}
+
+	void Add(int64_t input) {
+		SparkNarrowAccumulator::Add(sum, overflow, input);
+	}
+
+	// hugeint_t input whose statistics prove that it fits in int64 (see SparkAvgDecimalStats)
+	void Add(const hugeint_t &input) {
+		Add(static_cast<int64_t>(input.lower));
+	}
+
+	void AddConstant(int64_t input, idx_t count_p) {
+		SparkNarrowAccumulator::AddWide(sum, overflow, static_cast<__int128>(input) * static_cast<__int128>(count_p));
+	}
+
+	void AddConstant(const hugeint_t &input, idx_t count_p) {
+		AddConstant(static_cast<int64_t>(input.lower), count_p);
+	}
+
+	void AddBlock(__int128 total, idx_t valid_count) {
+		count += valid_count;
+		SparkNarrowAccumulator::AddWide(sum, overflow, total);
+	}
+
+	void Combine(const SparkAvgDecimalNarrowState &other) {
+		count += other.count;
+		SparkNarrowAccumulator::Add(sum, overflow, other.sum);
+		overflow += other.overflow;
+	}
+
+	__int128 Sum() const {
+		return SparkNarrowAccumulator::Get(sum, overflow);
 	}
 };
 
+template <typename INPUT_TYPE>
+struct SparkAvgDecimalStateFor {
+	using type = SparkAvgDecimalNarrowState;
+};
+
+template <>
+struct SparkAvgDecimalStateFor<hugeint_t> {
+	using type = SparkAvgDecimalState;
+};
+
 // Templatized so Finalize can target different physical result types
 template <typename RESULT_TYPE>
 struct SparkAvgDecimalOperation {
@@ -256,13 +886,13 @@ struct SparkAvgDecimalOperation {
 	template <class INPUT_TYPE, class STATE, class OP>
 	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &) {
 		state.count++;
-		state.sum += hugeint_t(input);
+		state.Add(input);
 	}
 
 	template <class INPUT_TYPE, class STATE, class OP>
 	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &, idx_t count) {
 		state.count += count;
-		state.sum += hugeint_t(input) * Hugeint::Convert(static_cast<int64_t>(count));
+		state.AddConstant(input, count);
 	}
 
 	template <class STATE, class OP>
@@ -284,13 +914,13 @@ struct SparkAvgDecimalOperation {
 		uint32_t scale_adj = static_cast<uint32_t>(bind_data.result_scale) -
 		                     static_cast<uint32_t>(bind_data.input_scale);
 
-		__int128 sum_val = HugeintToInt128(state.sum);
+		__int128 sum_val = state.Sum();
 		__int128 count_val = static_cast<__int128>(state.count);
 
 		unsigned __int128 pow10_val = (scale_adj > 0) ? Pow10_128(scale_adj) : 0;
 		__int128 result = SparkDecimalDivide(sum_val, count_val, pow10_val);
 
-		WriteAggResult(target, result);
+		WriteAggResultChecked(target, result, finalize_data);
 	}
 
 	static bool IgnoreNull() {
@@ -298,12 +928,60 @@ struct SparkAvgDecimalOperation {
 	}
 };
 
-// Helper: create a SparkAvgDecimal AggregateFunction for a specific result physical type
-template <typename RESULT_TYPE>
+// Helper: create a SparkAvgDecimal AggregateFunction for specific input/result physical types
+template <typename INPUT_TYPE, typename RESULT_TYPE,
+          typename STATE = typename SparkAvgDecimalStateFor<INPUT_TYPE>::type>
 static AggregateFunction GetSparkAvgDecimalFunction() {
-	return AggregateFunction::UnaryAggregate<SparkAvgDecimalState, hugeint_t, RESULT_TYPE,
-	                                          SparkAvgDecimalOperation<RESULT_TYPE>>(
-	    LogicalType::DECIMAL(38, 0), LogicalType::DECIMAL(38, 0));
+	auto function =
+	    AggregateFunction::UnaryAggregate<STATE, INPUT_TYPE, RESULT_TYPE, SparkAvgDecimalOperation<RESULT_TYPE>>(
+	        LogicalType::DECIMAL(38, 0), LogicalType::DECIMAL(38, 0));
+	function.update = SparkDecimalScatterUpdate<STATE, INPUT_TYPE, SparkAvgDecimalOperation<RESULT_TYPE>>;
+	// Ungrouped aggregation: sum each vector locally, fold into the state once
+	function.simple_update = SparkDecimalBlockSimpleUpdate<STATE, INPUT_TYPE>;
+	// Window frames: prefix sums over the partition
+	function.window_init = SparkDecimalWindowInit<STATE, INPUT_TYPE>;
+	function.window = SparkDecimalWindow<STATE, RESULT_TYPE, SparkAvgDecimalOperation<RESULT_TYPE>>;
+	return function;
+}
+
+template <typename INPUT_TYPE>
+static AggregateFunction GetSparkAvgDecimalFunction(PhysicalType result_type) {
+	switch (result_type) {
+	case PhysicalType::INT16:
+		return GetSparkAvgDecimalFunction<INPUT_TYPE, int16_t>();
+	case PhysicalType::INT32:
+		return GetSparkAvgDecimalFunction<INPUT_TYPE, int32_t>();
+	case PhysicalType::INT64:
+		return GetSparkAvgDecimalFunction<INPUT_TYPE, int64_t>();
+	case PhysicalType::INT128:
+		return GetSparkAvgDecimalFunction<INPUT_TYPE, hugeint_t>();
+	default:
+		throw InternalException("Unexpected physical type for spark_avg DECIMAL result");
+	}
+}
+
+static AggregateFunction GetSparkAvgDecimalFunction(PhysicalType input_type, PhysicalType result_type) {
+	switch (input_type) {
+	case PhysicalType::INT16:
+		return GetSparkAvgDecimalFunction<int16_t>(result_type);
+	case PhysicalType::INT32:
+		return GetSparkAvgDecimalFunction<int32_t>(result_type);
+	case PhysicalType::INT64:
+		return GetSparkAvgDecimalFunction<int64_t>(result_type);
+	case PhysicalType::INT128:
+		return GetSparkAvgDecimalFunction<hugeint_t>(result_type);
+	default:
+		throw InternalException("Unexpected physical type for spark_avg DECIMAL input");
+	}
+}
+
+// hugeint_t input accumulated in the 64-bit state (values proven to fit by statistics).
+// p > 18 always yields a hugeint_t result.
+static AggregateFunction GetSparkAvgDecimalNarrowedFunction(PhysicalType result_type) {
+	if (result_type != PhysicalType::INT128) {
+		throw InternalException("Unexpected physical type for spark_avg DECIMAL result");
+	}
+	return GetSparkAvgDecimalFunction<hugeint_t, hugeint_t, SparkAvgDecimalNarrowState>();
 }
 
 static unique_ptr<FunctionData> BindSparkAvgDecimal(ClientContext &context, AggregateFunction &function,
@@ -316,82 +994,804 @@ static unique_ptr<FunctionData> BindSparkAvgDecimal(ClientContext &context, Aggr
 	uint8_t p = DecimalType::GetWidth(type);
 	uint8_t s = DecimalType::GetScale(type);
 	auto result = ComputeAvgType(p, s);
-
-	// Promote input to DECIMAL(38, s) -> hugeint_t physical type
-	function.arguments[0] = LogicalType::DECIMAL(38, s);
 	auto result_type = LogicalType::DECIMAL(result.precision, result.scale);
+
+	// Take the input in its native width (no cast) and select the state and
+	// finalize implementation for the input and result physical types.
+	SetSparkAggregateImplementation(function,
+	                                GetSparkAvgDecimalFunction(type.InternalType(), result_type.InternalType()));
+	function.arguments[0] = type;
 	function.return_type = result_type;
 
-	// Select the correct function implementation based on result physical type
-	{
-		AggregateFunction tf = [&]() -> AggregateFunction {
-			switch (result_type.InternalType()) {
-			case PhysicalType::INT16:
-				return GetSparkAvgDecimalFunction<int16_t>();
-			case PhysicalType::INT32:
-				return GetSparkAvgDecimalFunction<int32_t>();
-			case PhysicalType::INT64:
-				return GetSparkAvgDecimalFunction<int64_t>();
-			case PhysicalType::INT128:
-				return GetSparkAvgDecimalFunction<hugeint_t>();
-			default:
-				throw InternalException("Unexpected physical type for spark_avg DECIMAL result");
-			}
-		}();
-		function.update = tf.update;
-		function.combine = tf.combine;
-		function.finalize = tf.finalize;
-		function.simple_update = tf.simple_update;
-	}
+	return make_uniq<SparkAggBindData>(s, result, SparkAnsiEnabled(context));
+}
 
-	return make_uniq<SparkAggBindData>(s, result.scale);
+// Statistics of a spark_avg result of type result_type over input_type values
+// in [min_val, max_val]: the average lies within the input range, rescaled to
+// the result scale. nullptr when it does not fit the result precision.
+static unique_ptr<BaseStatistics> SparkAvgDecimalResultStats(const LogicalType &input_type,
+                                                             const LogicalType &result_type, __int128 min_val,
+                                                             __int128 max_val) {
+	auto input_scale = DecimalType::GetScale(input_type);
+	auto width = DecimalType::GetWidth(result_type);
+	auto scale = DecimalType::GetScale(result_type);
+	if (scale < input_scale) {
+		return nullptr;
+	}
+	auto factor = static_cast<__int128>(Pow10_128(scale - input_scale));
+	__int128 avg_min, avg_max;
+	if (__builtin_mul_overflow(min_val, factor, &avg_min) || __builtin_mul_overflow(max_val, factor, &avg_max) ||
+	    !FitsDecimalWidth(avg_min, width) || !FitsDecimalWidth(avg_max, width)) {
+		return nullptr;
+	}
+	return MakeDecimalStats(result_type, avg_min, avg_max, true);
 }
 
-// spark_count is NOT needed as a separate extension function.
-// DuckDB's built-in COUNT already returns BIGINT, matching Spark semantics.
+// Statistics: narrows hugeint_t inputs like SparkSumDecimalStats
+static unique_ptr<BaseStatistics> SparkAvgDecimalStats(ClientContext &context, BoundAggregateExpression &expr,
+                                                       AggregateStatisticsInput &input) {
+	__int128 min_val, max_val;
+	if (!TryGetDecimalStatsBounds(input.child_stats[0], min_val, max_val)) {
+		return nullptr;
+	}
+	auto result_physical = expr.function.return_type.InternalType();
+	if (expr.children[0]->return_type.InternalType() == PhysicalType::INT128 && BoundsFitInt64(min_val, max_val)) {
+		SetSparkAggregateImplementation(expr.function, GetSparkAvgDecimalNarrowedFunction(result_physical));
+	}
+	return SparkAvgDecimalResultStats(expr.children[0]->return_type, expr.return_type, min_val, max_val);
+}
 
 // ============================================================================
-// Factory functions to create the AggregateFunctionSets
+// spark_avg: Integer and floating-point paths
+//
+// Spark: AVG(byte/short/int/long/float/double) -> DOUBLE, sum / count.
+// Integer inputs accumulate exactly in SparkAvgDecimalNarrowState (int64_t plus
+// a wrap counter, so no addition can overflow) and are converted to double
+// once at finalize. This deviates from Spark, which casts each row to double
+// and sums in double: the results agree while every running sum stays within
+// 2^53, beyond that Spark's result depends on the row order and loses digits
+// that this one keeps. FLOAT and DOUBLE inputs are summed in double row by
+// row, as in Spark.
 // ============================================================================
 
-inline AggregateFunctionSet CreateSparkSumFunctionSet() {
-	AggregateFunctionSet set("spark_sum");
+struct SparkAvgDoubleState {
+	double sum;
+	uint64_t count;
+
+	void Initialize() {
+		count = 0;
+		sum = 0;
+	}
+
+	void Add(double input) {
+		sum += input;
+	}
+
+	// Repeated addition, not input * count: Spark adds every row, and the
+	// rounding differs (0.1 added ten times is 0.9999999999999999, 0.1 * 10 is
+	// 1.0). count_p is at most one vector.
+	void AddConstant(double input, idx_t count_p) {
+		for (idx_t i = 0; i < count_p; i++) {
+			sum += input;
+		}
+	}
+
+	void Combine(const SparkAvgDoubleState &other) {
+		count += other.count;
+		sum += other.sum;
+	}
+
+	double Sum() const {
+		return sum;
+	}
+};
+
+struct SparkAvgNumericOperation {
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.Initialize();
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &) {
+		state.count++;
+		state.Add(input);
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &, idx_t count) {
+		state.count += count;
+		state.AddConstant(input, count);
+	}
+
+	template <class STATE, class OP>
+	static void Combine(const STATE &source, STATE &target, AggregateInputData &) {
+		target.Combine(source);
+	}
+
+	template <class T, class STATE>
+	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
+		if (state.count == 0) {
+			finalize_data.ReturnNull();
+		} else {
+			target = static_cast<double>(state.Sum()) / static_cast<double>(state.count);
+		}
+	}
+
+	static bool IgnoreNull() {
+		return true;
+	}
+};
+
+template <typename STATE, typename INPUT_TYPE>
+static AggregateFunction GetSparkAvgNumericFunction(const LogicalType &input_type) {
+	auto function = AggregateFunction::UnaryAggregate<STATE, INPUT_TYPE, double, SparkAvgNumericOperation>(
+	    input_type, LogicalType::DOUBLE);
+	function.order_dependent = AggregateOrderDependent::NOT_ORDER_DEPENDENT;
+	return function;
+}
+
+// ============================================================================
+// spark_var_samp / spark_var_pop / spark_stddev_samp / spark_stddev_pop:
+// DECIMAL path
+//
+// Count, sum and sum of squares of the scaled inputs are accumulated exactly
+// in integer state. Combine is plain addition, so partial states from
+// parallel threads merge in any order with identical results (no Welford
+// recurrence), and the only rounding happens once at finalize:
+//   var = (n * sum_squares - sum^2) / (n * (n - ddof)) / 10^(2s)
+// For n < 2^64 rows of |v| < 10^38: |sum| < 2^191 (SparkWindowSum),
+// sum_squares < 2^317 (5 limbs) and the numerator < 2^381 (6 limbs).
+//
+// Returns DOUBLE as Spark does. An empty group is NULL; so is a single row for
+// the sample variants (Spark's default, spark.sql.legacy.statisticalAggregate
+// = false).
+// ============================================================================
+
+// Little-endian 64-bit limb helpers. Callers size the targets so that the
+// results cannot overflow.
+static inline void SparkAddLimbs(uint64_t *target, idx_t target_limbs, const uint64_t *value, idx_t value_limbs) {
+	unsigned __int128 carry = 0;
+	for (idx_t i = 0; i < target_limbs; i++) {
+		carry += target[i];
+		if (i < value_limbs) {
+			carry += value[i];
+		}
+		target[i] = static_cast<uint64_t>(carry);
+		carry >>= 64;
+	}
+}
+
+// target -= value, requires target >= value
+static inline void SparkSubtractLimbs(uint64_t *target, const uint64_t *value, idx_t limbs) {
+	uint64_t borrow = 0;
+	for (idx_t i = 0; i < limbs; i++) {
+		unsigned __int128 diff = static_cast<unsigned __int128>(target[i]) - value[i] - borrow;
+		target[i] = static_cast<uint64_t>(diff);
+		borrow = static_cast<uint64_t>(diff >> 64) & 1;
+	}
+}
+
+// result (a_limbs + b_limbs limbs) = a * b, schoolbook
+static inline void SparkMultiplyLimbs(const uint64_t *a, idx_t a_limbs, const uint64_t *b, idx_t b_limbs,
+                                      uint64_t *result) {
+	memset(result, 0, (a_limbs + b_limbs) * sizeof(uint64_t));
+	for (idx_t i = 0; i < a_limbs; i++) {
+		unsigned __int128 carry = 0;
+		for (idx_t j = 0; j < b_limbs; j++) {
+			carry += static_cast<unsigned __int128>(a[i]) * b[j] + result[i + j];
+			result[i + j] = static_cast<uint64_t>(carry);
+			carry >>= 64;
+		}
+		result[i + b_limbs] = static_cast<uint64_t>(carry);
+	}
+}
+
+static inline long double SparkLimbsToLongDouble(const uint64_t *limbs, idx_t count) {
+	long double result = 0;
+	for (idx_t i = count; i > 0; i--) {
+		result = result * 18446744073709551616.0L + static_cast<long double>(limbs[i - 1]);
+	}
+	return result;
+}
+
+struct SparkVarianceDecimalState {
+	static constexpr idx_t SQUARES_LIMBS = 5;
+
+	uint64_t count;
+	SparkWindowSum sum;
+	uint64_t squares[SQUARES_LIMBS];
+
+	void Initialize() {
+		count = 0;
+		sum = SparkWindowSum();
+		memset(squares, 0, sizeof(squares));
+	}
+
+	void AddSquare(const uint256_t &square, uint64_t multiplier) {
+		uint64_t square_limbs[4] = {static_cast<uint64_t>(square.lo), static_cast<uint64_t>(square.lo >> 64),
+		                            static_cast<uint64_t>(square.hi), static_cast<uint64_t>(square.hi >> 64)};
+		if (multiplier == 1) {
+			SparkAddLimbs(squares, SQUARES_LIMBS, square_limbs, 4);
+			return;
+		}
+		uint64_t product[SQUARES_LIMBS];
+		SparkMultiplyLimbs(square_limbs, 4, &multiplier, 1, product);
+		SparkAddLimbs(squares, SQUARES_LIMBS, product, SQUARES_LIMBS);
+	}
+
+	void Add(__int128 input) {
+		count++;
+		sum.Add(input);
+		auto magnitude = Abs128(input);
+		if ((magnitude >> 64) == 0) {
+			// DECIMAL(p <= 18) inputs: a single 64x64 multiply
+			auto square = static_cast<unsigned __int128>(static_cast<uint64_t>(magnitude)) *
+			              static_cast<uint64_t>(magnitude);
+			AddSquare(uint256_t {0, square}, 1);
+		} else {
+			AddSquare(Mul128(magnitude, magnitude), 1);
+		}
+	}
+
+	void AddConstant(__int128 input, idx_t count_p) {
+		count += count_p;
+		// input * count can exceed 128 bits: add |input| * count as a 192-bit value
+		uint64_t multiplier = count_p;
+		auto magnitude = Abs128(input);
+		uint64_t magnitude_limbs[2] = {static_cast<uint64_t>(magnitude), static_cast<uint64_t>(magnitude >> 64)};
+		uint64_t total[3];
+		SparkMultiplyLimbs(magnitude_limbs, 2, &multiplier, 1, total);
+		SparkWindowSum block;
+		block.lo = total[0];
+		block.mid = total[1];
+		block.hi = static_cast<int64_t>(total[2]);
+		if (input < 0) {
+			sum.Subtract(block);
+		} else {
+			sum.Add(block);
+		}
+		AddSquare(Mul128(magnitude, magnitude), multiplier);
+	}
+
+	void Combine(const SparkVarianceDecimalState &other) {
+		count += other.count;
+		sum.Add(other.sum);
+		SparkAddLimbs(squares, SQUARES_LIMBS, other.squares, SQUARES_LIMBS);
+	}
+
+	// Variance of the unscaled values; requires count > ddof
+	long double Variance(uint64_t ddof, uint8_t scale) const {
+		// n * sum_squares
+		uint64_t numerator[SQUARES_LIMBS + 1];
+		SparkMultiplyLimbs(squares, SQUARES_LIMBS, &count, 1, numerator);
+
+		// sum^2 from the 192-bit magnitude of the sum
+		SparkWindowSum magnitude = sum;
+		if (sum.hi < 0) {
+			magnitude = SparkWindowSum();
+			magnitude.Subtract(sum);
+		}
+		uint64_t sum_limbs[3] = {magnitude.lo, magnitude.mid, static_cast<uint64_t>(magnitude.hi)};
+		uint64_t sum_square[6];
+		SparkMultiplyLimbs(sum_limbs, 3, sum_limbs, 3, sum_square);
+
+		// Exact and non-negative (Cauchy-Schwarz): n * sum(v^2) >= (sum v)^2
+		SparkSubtractLimbs(numerator, sum_square, SQUARES_LIMBS + 1);
+
+		auto n = static_cast<long double>(count);
+		auto scale_factor = static_cast<long double>(Pow10_128(scale));
+		return SparkLimbsToLongDouble(numerator, SQUARES_LIMBS + 1) / (n * (n - static_cast<long double>(ddof))) /
+		       scale_factor / scale_factor;
+	}
+};
+
+struct SparkVarianceBindData : public FunctionData {
+	uint8_t input_scale;
+
+	explicit SparkVarianceBindData(uint8_t input_scale_p) : input_scale(input_scale_p) {
+	}
+
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<SparkVarianceBindData>(input_scale);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		return input_scale == other_p.Cast<SparkVarianceBindData>().input_scale;
+	}
+};
+
+struct SparkVarSampOp {
+	static constexpr const char *NAME = "spark_var_samp";
+	static constexpr uint64_t DDOF = 1;
+	static constexpr bool STDDEV = false;
+};
+
+struct SparkVarPopOp {
+	static constexpr const char *NAME = "spark_var_pop";
+	static constexpr uint64_t DDOF = 0;
+	static constexpr bool STDDEV = false;
+};
+
+struct SparkStddevSampOp {
+	static constexpr const char *NAME = "spark_stddev_samp";
+	static constexpr uint64_t DDOF = 1;
+	static constexpr bool STDDEV = true;
+};
+
+struct SparkStddevPopOp {
+	static constexpr const char *NAME = "spark_stddev_pop";
+	static constexpr uint64_t DDOF = 0;
+	static constexpr bool STDDEV = true;
+};
+
+template <typename VARIANCE_OP>
+struct SparkVarianceDecimalOperation {
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.Initialize();
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &) {
+		state.Add(DecimalToInt128(input));
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &, idx_t count) {
+		state.AddConstant(DecimalToInt128(input), count);
+	}
+
+	template <class STATE, class OP>
+	static void Combine(const STATE &source, STATE &target, AggregateInputData &) {
+		target.Combine(source);
+	}
+
+	template <class T, class STATE>
+	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
+		if (state.count <= VARIANCE_OP::DDOF) {
+			finalize_data.ReturnNull();
+			return;
+		}
+		auto &bind_data = finalize_data.input.bind_data->Cast<SparkVarianceBindData>();
+		auto variance = state.Variance(VARIANCE_OP::DDOF, bind_data.input_scale);
+		target = static_cast<T>(VARIANCE_OP::STDDEV ? std::sqrt(variance) : variance);
+	}
+
+	static bool IgnoreNull() {
+		return true;
+	}
+};
+
+template <typename INPUT_TYPE, typename VARIANCE_OP>
+static AggregateFunction GetSparkVarianceDecimalFunction() {
+	return AggregateFunction::UnaryAggregate<SparkVarianceDecimalState, INPUT_TYPE, double,
+	                                         SparkVarianceDecimalOperation<VARIANCE_OP>>(LogicalType::DECIMAL(38, 0),
+	                                                                                     LogicalType::DOUBLE);
+}
+
+template <typename VARIANCE_OP>
+static AggregateFunction GetSparkVarianceDecimalFunction(PhysicalType input_type) {
+	switch (input_type) {
+	case PhysicalType::INT16:
+		return GetSparkVarianceDecimalFunction<int16_t, VARIANCE_OP>();
+	case PhysicalType::INT32:
+		return GetSparkVarianceDecimalFunction<int32_t, VARIANCE_OP>();
+	case PhysicalType::INT64:
+		return GetSparkVarianceDecimalFunction<int64_t, VARIANCE_OP>();
+	case PhysicalType::INT128:
+		return GetSparkVarianceDecimalFunction<hugeint_t, VARIANCE_OP>();
+	default:
+		throw InternalException("Unexpected physical type for %s DECIMAL input", VARIANCE_OP::NAME);
+	}
+}
+
+template <typename VARIANCE_OP>
+static unique_ptr<FunctionData> BindSparkVarianceDecimal(ClientContext &context, AggregateFunction &function,
+                                                         vector<unique_ptr<Expression>> &arguments) {
+	auto &type = arguments[0]->return_type;
+	if (type.id() != LogicalTypeId::DECIMAL) {
+		throw InvalidInputException("%s DECIMAL overload requires DECIMAL argument", VARIANCE_OP::NAME);
+	}
+	// Take the input in its native width (no cast)
+	SetSparkAggregateImplementation(function, GetSparkVarianceDecimalFunction<VARIANCE_OP>(type.InternalType()));
+	function.arguments[0] = type;
+	return make_uniq<SparkVarianceBindData>(DecimalType::GetScale(type));
+}
+
+// ============================================================================
+// spark_approx_count_distinct(DECIMAL x [, rsd]): HyperLogLog++
+//
+// Hashes the scaled values as Spark does (XXH64 with seed 42, see
+// spark_hash.hpp) into 2^p registers, p derived from rsd (default 0.05).
+// The registers are allocated from the aggregate's arena on the first value,
+// so an empty group costs one pointer. Returns BIGINT, 0 for no values.
+// ============================================================================
+
+struct SparkApproxCountDistinctBindData : public FunctionData {
+	uint8_t precision; // register index bits
+
+	explicit SparkApproxCountDistinctBindData(uint8_t precision_p) : precision(precision_p) {
+	}
+
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<SparkApproxCountDistinctBindData>(precision);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		return precision == other_p.Cast<SparkApproxCountDistinctBindData>().precision;
+	}
+};
+
+struct SparkApproxCountDistinctState {
+	uint8_t *registers; // nullptr until the first value
+};
+
+struct SparkApproxCountDistinctOperation {
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.registers = nullptr;
+	}
+
+	static uint8_t *AllocateRegisters(AggregateInputData &aggr_input_data, uint8_t precision) {
+		auto size = SparkHyperLogLog::RegisterCount(precision);
+		auto registers = aggr_input_data.allocator.Allocate(size);
+		memset(registers, 0, size);
+		return registers;
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &unary_input) {
+		auto precision = unary_input.input.bind_data->Cast<SparkApproxCountDistinctBindData>().precision;
+		if (!state.registers) {
+			state.registers = AllocateRegisters(unary_input.input, precision);
+		}
+		SparkHyperLogLog::Update(state.registers, precision, SparkXxHash64::HashDecimal(input, SPARK_HLL_SEED));
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &unary_input, idx_t) {
+		Operation<INPUT_TYPE, STATE, OP>(state, input, unary_input);
+	}
+
+	template <class STATE, class OP>
+	static void Combine(const STATE &source, STATE &target, AggregateInputData &aggr_input_data) {
+		if (!source.registers) {
+			return;
+		}
+		auto precision = aggr_input_data.bind_data->Cast<SparkApproxCountDistinctBindData>().precision;
+		if (!target.registers) {
+			target.registers = AllocateRegisters(aggr_input_data, precision);
+		}
+		SparkHyperLogLog::Merge(target.registers, source.registers, precision);
+	}
+
+	template <class T, class STATE>
+	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
+		if (!state.registers) {
+			target = 0;
+			return;
+		}
+		auto precision = finalize_data.input.bind_data->Cast<SparkApproxCountDistinctBindData>().precision;
+		target = SparkHyperLogLog::Estimate(state.registers, precision);
+	}
+
+	static bool IgnoreNull() {
+		return true;
+	}
+};
+
+template <typename INPUT_TYPE>
+static AggregateFunction GetSparkApproxCountDistinctFunction() {
+	return AggregateFunction::UnaryAggregate<SparkApproxCountDistinctState, INPUT_TYPE, int64_t,
+	                                         SparkApproxCountDistinctOperation>(LogicalType::DECIMAL(38, 0),
+	                                                                            LogicalType::BIGINT);
+}
+
+static AggregateFunction GetSparkApproxCountDistinctFunction(PhysicalType input_type) {
+	switch (input_type) {
+	case PhysicalType::INT16:
+		return GetSparkApproxCountDistinctFunction<int16_t>();
+	case PhysicalType::INT32:
+		return GetSparkApproxCountDistinctFunction<int32_t>();
+	case PhysicalType::INT64:
+		return GetSparkApproxCountDistinctFunction<int64_t>();
+	case PhysicalType::INT128:
+		return GetSparkApproxCountDistinctFunction<hugeint_t>();
+	default:
+		throw InternalException("Unexpected physical type for spark_approx_count_distinct DECIMAL input");
+	}
+}
+
+// Constant argument of a sketch aggregate (rsd, percentage or accuracy)
+static Value GetSparkSketchArgument(ClientContext &context, Expression &expr, const char *function_name,
+                                    const char *what) {
+	if (!expr.IsFoldable()) {
+		throw BinderException("%s: %s must be a constant", function_name, what);
+	}
+	auto value = ExpressionExecutor::EvaluateScalar(context, expr);
+	if (value.IsNull()) {
+		throw BinderException("%s: %s cannot be NULL", function_name, what);
+	}
+	return value;
+}
+
+static unique_ptr<FunctionData> BindSparkApproxCountDistinct(ClientContext &context, AggregateFunction &function,
+                                                             vector<unique_ptr<Expression>> &arguments) {
+	auto &type = arguments[0]->return_type;
+	if (type.id() != LogicalTypeId::DECIMAL) {
+		throw InvalidInputException("spark_approx_count_distinct requires DECIMAL argument");
+	}
+	double rsd = SparkHyperLogLog::DEFAULT_RSD;
+	if (arguments.size() > 1) {
+		rsd = GetSparkSketchArgument(context, *arguments[1], "spark_approx_count_distinct", "rsd")
+		          .GetValue<double>();
+		Function::EraseArgument(function, arguments, 1);
+	}
+	auto precision = SparkHyperLogLog::Precision(rsd);
+	if (precision < SparkHyperLogLog::MIN_PRECISION) {
+		throw BinderException("spark_approx_count_distinct: HLL++ requires at least 4 bits for addressing, use an rsd "
+		                      "of at most 0.39 (current value = %f)",
+		                      rsd);
+	}
+	if (precision > SparkHyperLogLog::MAX_PRECISION) {
+		throw BinderException("spark_approx_count_distinct: an rsd of %f needs 2^%d registers, at most 2^%d are "
+		                      "supported (use an rsd of at least 0.0022)",
+		                      rsd, precision, static_cast<int32_t>(SparkHyperLogLog::MAX_PRECISION));
+	}
+
+	SetSparkAggregateImplementation(function, GetSparkApproxCountDistinctFunction(type.InternalType()));
+	function.arguments[0] = type;
+	return make_uniq<SparkApproxCountDistinctBindData>(static_cast<uint8_t>(precision));
+}
+
+// ============================================================================
+// spark_percentile_approx(DECIMAL x, percentage [, accuracy]):
+// Greenwald-Khanna summary
+//
+// relative_error = 1 / accuracy (default accuracy 10000), as in Spark. The
+// percentage is a constant in [0, 1], or a constant list of them for a list
+// result. Returns inserted values, so the result has the input type; NULL
+// for no values. Summaries are heap-allocated on the first value and freed
+// by the destructor.
+// ============================================================================
+
+static constexpr int32_t SPARK_PERCENTILE_DEFAULT_ACCURACY = 10000;
+
+struct SparkPercentileApproxBindData : public FunctionData {
+	vector<double> percentages;
+	bool list_result; // percentage was a list
+	int32_t accuracy;
+
+	SparkPercentileApproxBindData(vector<double> percentages_p, bool list_result_p, int32_t accuracy_p)
+	    : percentages(std::move(percentages_p)), list_result(list_result_p), accuracy(accuracy_p) {
+	}
+
+	double RelativeError() const {
+		return 1.0 / accuracy;
+	}
+
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<SparkPercentileApproxBindData>(percentages, list_result, accuracy);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<SparkPercentileApproxBindData>();
+		return percentages == other.percentages && list_result == other.list_result && accuracy == other.accuracy;
+	}
+};
+
+// DECIMAL(p <= 18) values are kept as int64_t, wider ones as __int128
+template <typename INPUT_TYPE>
+struct SparkPercentileValueFor {
+	using type = int64_t;
+};
+
+template <>
+struct SparkPercentileValueFor<hugeint_t> {
+	using type = __int128;
+};
+
+template <typename VALUE>
+struct SparkPercentileApproxState {
+	SparkQuantileSummary<VALUE> *summary; // nullptr until the first value
+};
+
+struct SparkPercentileApproxOperation {
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.summary = nullptr;
+	}
+
+	template <class STATE>
+	static void EnsureSummary(STATE &state, AggregateInputData &aggr_input_data) {
+		using SUMMARY = typename std::remove_pointer<decltype(state.summary)>::type;
+		if (!state.summary) {
+			state.summary =
+			    new SUMMARY(aggr_input_data.bind_data->Cast<SparkPercentileApproxBindData>().RelativeError());
+		}
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &unary_input) {
+		EnsureSummary(state, unary_input.input);
+		state.summary->Insert(static_cast<typename SparkPercentileValueFor<INPUT_TYPE>::type>(DecimalToInt128(input)));
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &unary_input,
+	                              idx_t count) {
+		for (idx_t i = 0; i < count; i++) {
+			Operation<INPUT_TYPE, STATE, OP>(state, input, unary_input);
+		}
+	}
+
+	template <class STATE, class OP>
+	static void Combine(const STATE &source, STATE &target, AggregateInputData &aggr_input_data) {
+		if (!source.summary) {
+			return;
+		}
+		EnsureSummary(target, aggr_input_data);
+		target.summary->Merge(*source.summary);
+	}
+
+	// Scalar percentage
+	template <class T, class STATE>
+	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
+		if (!state.summary || state.summary->Count() == 0) {
+			finalize_data.ReturnNull();
+			return;
+		}
+		auto &bind_data = finalize_data.input.bind_data->Cast<SparkPercentileApproxBindData>();
+		state.summary->Compress();
+		target = Int128ToDecimal<T>(state.summary->Query(bind_data.percentages[0]));
+	}
+
+	template <class STATE>
+	static void Destroy(STATE &state, AggregateInputData &) {
+		delete state.summary;
+		state.summary = nullptr;
+	}
+
+	static bool IgnoreNull() {
+		return true;
+	}
+};
+
+// List of percentages: one list entry per percentage
+template <class STATE, typename RESULT_TYPE>
+static void SparkPercentileApproxListFinalize(Vector &states, AggregateInputData &aggr_input_data, Vector &result,
+                                              idx_t count, idx_t offset) {
+	auto &bind_data = aggr_input_data.bind_data->Cast<SparkPercentileApproxBindData>();
+	auto &percentages = bind_data.percentages;
+	auto list_data = FlatVector::GetData<list_entry_t>(result);
+
+	UnifiedVectorFormat sdata;
+	states.ToUnifiedFormat(count, sdata);
+	auto state_ptrs = UnifiedVectorFormat::GetData<STATE *>(sdata);
+	for (idx_t i = 0; i < count; i++) {
+		auto &state = *state_ptrs[sdata.sel->get_index(i)];
+		idx_t row = i + offset;
+		if (!state.summary || state.summary->Count() == 0) {
+			FlatVector::SetNull(result, row, true);
+			continue;
+		}
+		state.summary->Compress();
+		auto list_offset = ListVector::GetListSize(result);
+		ListVector::Reserve(result, list_offset + percentages.size());
+		auto child_data = FlatVector::GetData<RESULT_TYPE>(ListVector::GetEntry(result));
+		for (idx_t j = 0; j < percentages.size(); j++) {
+			child_data[list_offset + j] = Int128ToDecimal<RESULT_TYPE>(state.summary->Query(percentages[j]));
+		}
+		ListVector::SetListSize(result, list_offset + percentages.size());
+		list_data[row].offset = list_offset;
+		list_data[row].length = percentages.size();
+	}
+}
+
+template <typename INPUT_TYPE>
+static AggregateFunction GetSparkPercentileApproxFunction(bool list_result) {
+	using STATE = SparkPercentileApproxState<typename SparkPercentileValueFor<INPUT_TYPE>::type>;
+	auto function = AggregateFunction::UnaryAggregateDestructor<STATE, INPUT_TYPE, INPUT_TYPE,
+	                                                            SparkPercentileApproxOperation>(
+	    LogicalType::DECIMAL(38, 0), LogicalType::DECIMAL(38, 0));
+	if (list_result) {
+		function.finalize = SparkPercentileApproxListFinalize<STATE, INPUT_TYPE>;
+	}
+	return function;
+}
+
+static AggregateFunction GetSparkPercentileApproxFunction(PhysicalType input_type, bool list_result) {
+	switch (input_type) {
+	case PhysicalType::INT16:
+		return GetSparkPercentileApproxFunction<int16_t>(list_result);
+	case PhysicalType::INT32:
+		return GetSparkPercentileApproxFunction<int32_t>(list_result);
+	case PhysicalType::INT64:
+		return GetSparkPercentileApproxFunction<int64_t>(list_result);
+	case PhysicalType::INT128:
+		return GetSparkPercentileApproxFunction<hugeint_t>(list_result);
+	default:
+		throw InternalException("Unexpected physical type for spark_percentile_approx DECIMAL input");
+	}
+}
+
+static double GetSparkPercentage(const Value &value) {
+	if (value.IsNull()) {
+		throw BinderException("spark_percentile_approx: percentage cannot be NULL");
+	}
+	auto percentage = value.GetValue<double>();
+	if (!(percentage >= 0 && percentage <= 1)) {
+		throw BinderException("spark_percentile_approx: all percentage values must be between 0.0 and 1.0 "
+		                      "(current = %s)",
+		                      value.ToString());
+	}
+	return percentage;
+}
+
+static unique_ptr<FunctionData> BindSparkPercentileApprox(ClientContext &context, AggregateFunction &function,
+                                                          vector<unique_ptr<Expression>> &arguments) {
+	auto &type = arguments[0]->return_type;
+	if (type.id() != LogicalTypeId::DECIMAL) {
+		throw InvalidInputException("spark_percentile_approx requires DECIMAL argument");
+	}
+
+	auto percentage = GetSparkSketchArgument(context, *arguments[1], "spark_percentile_approx", "percentage");
+	bool list_result = percentage.type().id() == LogicalTypeId::LIST;
+	vector<double> percentages;
+	if (list_result) {
+		for (auto &child : ListValue::GetChildren(percentage)) {
+			percentages.push_back(GetSparkPercentage(child));
+		}
+		if (percentages.empty()) {
+			throw BinderException("spark_percentile_approx: percentage list cannot be empty");
+		}
+	} else {
+		percentages.push_back(GetSparkPercentage(percentage));
+	}
+
+	int64_t accuracy = SPARK_PERCENTILE_DEFAULT_ACCURACY;
+	if (arguments.size() > 2) {
+		accuracy = GetSparkSketchArgument(context, *arguments[2], "spark_percentile_approx", "accuracy")
+		               .GetValue<int64_t>();
+		if (accuracy <= 0 || accuracy > NumericLimits<int32_t>::Maximum()) {
+			throw BinderException("spark_percentile_approx: accuracy must be between 1 and %d (current value = %d)",
+			                      NumericLimits<int32_t>::Maximum(), accuracy);
+		}
+		Function::EraseArgument(function, arguments, 2);
+	}
+	Function::EraseArgument(function, arguments, 1);
+
+	SetSparkAggregateImplementation(function, GetSparkPercentileApproxFunction(type.InternalType(), list_result));
+	function.arguments[0] = type;
+	function.return_type = list_result ? LogicalType::LIST(type) : type;
+	return make_uniq<SparkPercentileApproxBindData>(std::move(percentages), list_result,
+	                                                static_cast<int32_t>(accuracy));
+}
+
+// spark_count is NOT needed as a separate extension function.
+// DuckDB's built-in COUNT already returns BIGINT, matching Spark semantics.
+
+// ============================================================================
+// Factory functions to create the AggregateFunctionSets
+// ============================================================================
+
+inline AggregateFunctionSet CreateSparkSumFunctionSet() {
+	AggregateFunctionSet set("spark_sum");
 
 	// DECIMAL overload: input DECIMAL -> result DECIMAL(min(p+10,38), s)
-	// Initial template uses hugeint_t; bind function swaps to correct physical type
-	auto decimal_func = GetSparkSumDecimalFunction<hugeint_t>();
+	// Initial template uses hugeint_t; bind function swaps to the native input/result width
+	auto decimal_func = GetSparkSumDecimalFunction<hugeint_t, hugeint_t>();
 	decimal_func.bind = BindSparkSumDecimal;
+	decimal_func.statistics = SparkSumDecimalStats;
 	decimal_func.order_dependent = AggregateOrderDependent::NOT_ORDER_DEPENDENT;
 	set.AddFunction(decimal_func);
 
 	// Integer overloads: all return BIGINT (Spark semantics)
-	// TINYINT
-	auto tinyint_func = AggregateFunction::UnaryAggregate<SparkSumIntegerState, int8_t, int64_t,
-	                                                       SparkSumIntegerOperation>(
-	    LogicalType::TINYINT, LogicalType::BIGINT);
-	tinyint_func.order_dependent = AggregateOrderDependent::NOT_ORDER_DEPENDENT;
-	set.AddFunction(tinyint_func);
-
-	// SMALLINT
-	auto smallint_func = AggregateFunction::UnaryAggregate<SparkSumIntegerState, int16_t, int64_t,
-	                                                        SparkSumIntegerOperation>(
-	    LogicalType::SMALLINT, LogicalType::BIGINT);
-	smallint_func.order_dependent = AggregateOrderDependent::NOT_ORDER_DEPENDENT;
-	set.AddFunction(smallint_func);
-
-	// INTEGER
-	auto int_func = AggregateFunction::UnaryAggregate<SparkSumIntegerState, int32_t, int64_t,
-	                                                   SparkSumIntegerOperation>(
-	    LogicalType::INTEGER, LogicalType::BIGINT);
-	int_func.order_dependent = AggregateOrderDependent::NOT_ORDER_DEPENDENT;
-	set.AddFunction(int_func);
-
-	// BIGINT
-	auto bigint_func = AggregateFunction::UnaryAggregate<SparkSumIntegerState, int64_t, int64_t,
-	                                                      SparkSumIntegerOperation>(
-	    LogicalType::BIGINT, LogicalType::BIGINT);
-	bigint_func.order_dependent = AggregateOrderDependent::NOT_ORDER_DEPENDENT;
-	set.AddFunction(bigint_func);
+	set.AddFunction(GetSparkSumIntegerFunction<int8_t>(LogicalType::TINYINT));
+	set.AddFunction(GetSparkSumIntegerFunction<int16_t>(LogicalType::SMALLINT));
+	set.AddFunction(GetSparkSumIntegerFunction<int32_t>(LogicalType::INTEGER));
+	set.AddFunction(GetSparkSumIntegerFunction<int64_t>(LogicalType::BIGINT));
 
 	return set;
 }
@@ -400,15 +1800,81 @@ inline AggregateFunctionSet CreateSparkAvgFunctionSet() {
 	AggregateFunctionSet set("spark_avg");
 
 	// DECIMAL overload: input DECIMAL -> result DECIMAL(min(p+4,38), min(s+4,18))
-	// Initial template uses hugeint_t; bind function swaps to correct physical type
-	auto decimal_func = GetSparkAvgDecimalFunction<hugeint_t>();
+	// Initial template uses hugeint_t; bind function swaps to the native input/result width
+	auto decimal_func = GetSparkAvgDecimalFunction<hugeint_t, hugeint_t>();
 	decimal_func.bind = BindSparkAvgDecimal;
+	decimal_func.statistics = SparkAvgDecimalStats;
+	decimal_func.order_dependent = AggregateOrderDependent::NOT_ORDER_DEPENDENT;
+	set.AddFunction(decimal_func);
+
+	// Integer and floating-point overloads: all return DOUBLE (Spark semantics)
+	set.AddFunction(GetSparkAvgNumericFunction<SparkAvgDecimalNarrowState, int8_t>(LogicalType::TINYINT));
+	set.AddFunction(GetSparkAvgNumericFunction<SparkAvgDecimalNarrowState, int16_t>(LogicalType::SMALLINT));
+	set.AddFunction(GetSparkAvgNumericFunction<SparkAvgDecimalNarrowState, int32_t>(LogicalType::INTEGER));
+	set.AddFunction(GetSparkAvgNumericFunction<SparkAvgDecimalNarrowState, int64_t>(LogicalType::BIGINT));
+	set.AddFunction(GetSparkAvgNumericFunction<SparkAvgDoubleState, float>(LogicalType::FLOAT));
+	set.AddFunction(GetSparkAvgNumericFunction<SparkAvgDoubleState, double>(LogicalType::DOUBLE));
+
+	return set;
+}
+
+// spark_var_samp, spark_var_pop, spark_stddev_samp and spark_stddev_pop
+template <typename VARIANCE_OP>
+inline AggregateFunctionSet CreateSparkVarianceFunctionSet() {
+	AggregateFunctionSet set(VARIANCE_OP::NAME);
+
+	// DECIMAL overload: input DECIMAL -> result DOUBLE
+	// Initial template uses hugeint_t; bind function swaps to the native input width
+	auto decimal_func = GetSparkVarianceDecimalFunction<hugeint_t, VARIANCE_OP>();
+	decimal_func.bind = BindSparkVarianceDecimal<VARIANCE_OP>;
 	decimal_func.order_dependent = AggregateOrderDependent::NOT_ORDER_DEPENDENT;
 	set.AddFunction(decimal_func);
 
 	return set;
 }
 
+inline AggregateFunctionSet CreateSparkApproxCountDistinctFunctionSet() {
+	AggregateFunctionSet set("spark_approx_count_distinct");
+
+	// DECIMAL overloads: input DECIMAL [, rsd DOUBLE] -> BIGINT
+	// Initial template uses hugeint_t; bind function swaps to the native input width
+	for (idx_t with_rsd = 0; with_rsd < 2; with_rsd++) {
+		auto decimal_func = GetSparkApproxCountDistinctFunction<hugeint_t>();
+		if (with_rsd) {
+			decimal_func.arguments.push_back(LogicalType::DOUBLE);
+		}
+		decimal_func.bind = BindSparkApproxCountDistinct;
+		decimal_func.order_dependent = AggregateOrderDependent::NOT_ORDER_DEPENDENT;
+		set.AddFunction(decimal_func);
+	}
+
+	return set;
+}
+
+inline AggregateFunctionSet CreateSparkPercentileApproxFunctionSet() {
+	AggregateFunctionSet set("spark_percentile_approx");
+
+	// DECIMAL overloads: input DECIMAL, percentage DOUBLE or DOUBLE[] [, accuracy INTEGER]
+	// -> the input type, or a list of it
+	// Initial template uses hugeint_t; bind function swaps to the native input width
+	vector<LogicalType> percentage_types = {LogicalType::DOUBLE, LogicalType::LIST(LogicalType::DOUBLE)};
+	for (auto &percentage_type : percentage_types) {
+		for (idx_t with_accuracy = 0; with_accuracy < 2; with_accuracy++) {
+			auto decimal_func = GetSparkPercentileApproxFunction<hugeint_t>(false);
+			decimal_func.arguments.push_back(percentage_type);
+			if (with_accuracy) {
+				decimal_func.arguments.push_back(LogicalType::INTEGER);
+			}
+			decimal_func.bind = BindSparkPercentileApprox;
+			// The sampled values depend on the insertion order; the error bound does not
+			decimal_func.order_dependent = AggregateOrderDependent::NOT_ORDER_DEPENDENT;
+			set.AddFunction(decimal_func);
+		}
+	}
+
+	return set;
+}
+
 // No CreateSparkCountFunctionSet — DuckDB COUNT already matches Spark.
 
 } // namespace duckdb
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "wide_integer.hpp"
+
+namespace duckdb {
+
+// ---------------------------------------------------------------------------
+// ANSI vs legacy DECIMAL overflow (Spark's spark.sql.ansi.enabled)
+// ---------------------------------------------------------------------------
+// A result that does not fit its DECIMAL(p, s) type is NULL in legacy mode and
+// raises NUMERIC_VALUE_OUT_OF_RANGE in ANSI mode. The mode is resolved at bind
+// time and kept in the bind data, so kernels never look up the setting.
+// BIGINT sums wrap around in legacy mode, like Java long addition, and raise
+// ARITHMETIC_OVERFLOW in ANSI mode.
+
+static constexpr const char *SPARK_ANSI_SETTING = "spark_ansi_enabled";
+
+inline bool SparkAnsiEnabled(ClientContext &context) {
+	Value value;
+	if (!context.TryGetCurrentSetting(SPARK_ANSI_SETTING, value) || value.IsNull()) {
+		return false;
+	}
+	return BooleanValue::Get(value);
+}
+
+[[noreturn]] inline void ThrowSparkDecimalOverflow(const LogicalType &type) {
+	throw OutOfRangeException("NUMERIC_VALUE_OUT_OF_RANGE: result cannot be represented as %s (set %s = false to "
+	                          "return NULL instead)",
+	                          type.ToString(), SPARK_ANSI_SETTING);
+}
+
+[[noreturn]] inline void ThrowSparkLongOverflow() {
+	throw OutOfRangeException("ARITHMETIC_OVERFLOW: long overflow (set %s = false to wrap around instead)",
+	                          SPARK_ANSI_SETTING);
+}
+
+// Enforce |value| < 10^p on a computed result vector (flat or constant).
+// The vector's min and max are compared against the bound once, in a
+// branch-free pass over the data; only a vector that fails it is scanned row
+// by row (rows that are already NULL hold undefined data and may be the
+// ones failing). Returns the number of overflowing rows, which have been set
+// to NULL; in ANSI mode the first one throws instead.
+template <typename RESULT_TYPE>
+static idx_t SparkEnforceDecimalRange(Vector &result, idx_t count, bool ansi) {
+	auto &type = result.GetType();
+	auto bound = static_cast<__int128>(Pow10_128(DecimalType::GetWidth(type)));
+
+	if (result.GetVectorType() == VectorType::CONSTANT_VECTOR) {
+		if (ConstantVector::IsNull(result)) {
+			return 0;
+		}
+		auto value = DecimalToInt128(*ConstantVector::GetData<RESULT_TYPE>(result));
+		if (value > -bound && value < bound) {
+			return 0;
+		}
+		if (ansi) {
+			ThrowSparkDecimalOverflow(type);
+		}
+		ConstantVector::SetNull(result, true);
+		return count;
+	}
+
+	D_ASSERT(result.GetVectorType() == VectorType::FLAT_VECTOR);
+	auto *data = FlatVector::GetData<RESULT_TYPE>(result);
+	__int128 min_val = 0;
+	__int128 max_val = 0;
+	for (idx_t i = 0; i < count; i++) {
+		auto value = DecimalToInt128(data[i]);
+		min_val = value < min_val ? value : min_val;
+		max_val = value > max_val ? value : max_val;
+	}
+	if (__builtin_expect(min_val > -bound && max_val < bound, 1)) {
+		return 0;
+	}
+
+	auto &validity = FlatVector::Validity(result);
+	idx_t overflow_count = 0;
+	for (idx_t i = 0; i < count; i++) {
+		auto value = DecimalToInt128(data[i]);
+		if ((value <= -bound || value >= bound) && validity.RowIsValid(i)) {
+			if (ansi) {
+				ThrowSparkDecimalOverflow(type);
+			}
+			validity.SetInvalid(i);
+			overflow_count++;
+		}
+	}
+	return overflow_count;
+}
+
+} // namespace duckdb
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "wide_integer.hpp"
+#include "spark_precision.hpp"
+
+namespace duckdb {
+
+class ExtensionLoader;
+
+// ---------------------------------------------------------------------------
+// Spark-semantics DECIMAL multiply, add and subtract
+// ---------------------------------------------------------------------------
+// The exact result is formed at the exact scale (s1 + s2 for multiply,
+// max(s1, s2) for add/subtract) in up to 256 bits, then brought to the Spark
+// result scale with ROUND_HALF_UP in the same pass. A result that does not fit
+// the result precision is NULL (Spark's non-ANSI behavior).
+
+// Per-query parameters, precomputed at bind time.
+struct SparkArithParams {
+	unsigned __int128 limit; // 10^result_precision; |result| must stay below it
+	unsigned __int128 pow_a; // add/subtract: 10^(exact_scale - s1) aligns a (1 for multiply)
+	unsigned __int128 pow_b; // add/subtract: 10^(exact_scale - s2) aligns b (1 for multiply)
+	uint32_t drop;           // exact_scale - result_scale: digits removed with HALF_UP
+};
+
+inline SparkArithParams MakeSparkMultiplyParams(uint8_t s1, uint8_t s2, const SparkDecimalResult &result) {
+	return {Pow10_128(result.precision), 1, 1, static_cast<uint32_t>(s1) + s2 - result.scale};
+}
+
+inline SparkArithParams MakeSparkAddSubtractParams(uint8_t s1, uint8_t s2, const SparkDecimalResult &result) {
+	uint32_t exact_scale = std::max(s1, s2);
+	return {Pow10_128(result.precision), Pow10_128(exact_scale - s1), Pow10_128(exact_scale - s2),
+	        exact_scale - result.scale};
+}
+
+// Round the exact magnitude `mag` (at result scale + params.drop) to the result
+// scale with HALF_UP, apply the sign, and check the result precision.
+//
+// drop can exceed 38 for multiply (s1 + s2 up to 76, result scale down to 6).
+// The division is then split: truncate by 10^38 first, then divide by
+// 10^(drop - 38) with HALF_UP. With d2 = 10^(drop - 38) even, the full
+// remainder r2 * 10^38 + r1 reaches half of 10^drop exactly when r2 >= d2 / 2,
+// so rounding on the second remainder alone is exact.
+inline bool SparkRoundToResult(uint256_t mag, bool negative, const SparkArithParams &params, __int128 &result) {
+	unsigned __int128 quotient;
+	if (params.drop == 0) {
+		if (mag.hi != 0) {
+			return false;
+		}
+		quotient = mag.lo;
+	} else {
+		uint32_t drop = params.drop;
+		if (drop > 38) {
+			unsigned __int128 pow38 = Pow10_128(38);
+			if (mag.hi >= pow38) {
+				return false;
+			}
+			mag = {0, Div256By128(mag, pow38, nullptr)};
+			drop -= 38;
+		}
+		unsigned __int128 divisor = Pow10_128(drop);
+		if (mag.hi >= divisor) {
+			return false; // quotient needs more than 128 bits
+		}
+		unsigned __int128 remainder;
+		quotient = Div256By128(mag, divisor, &remainder);
+		// 2 * remainder >= divisor, without overflowing
+		if (remainder >= divisor - remainder) {
+			quotient++;
+		}
+	}
+	if (quotient >= params.limit) {
+		return false;
+	}
+	result = negative ? -static_cast<__int128>(quotient) : static_cast<__int128>(quotient);
+	return true;
+}
+
+// a * b. Returns false when the result overflows the result precision.
+inline bool SparkDecimalMultiply(__int128 a, __int128 b, const SparkArithParams &params, __int128 &result) {
+	if (__builtin_expect(params.drop == 0, 1)) {
+		// Common case: no scale reduction, the product usually fits in 128 bits
+		__int128 product;
+		if (!__builtin_mul_overflow(a, b, &product)) {
+			result = product;
+			return Abs128(product) < params.limit;
+		}
+	}
+	return SparkRoundToResult(Mul128(Abs128(a), Abs128(b)), (a < 0) != (b < 0), params, result);
+}
+
+// a + b. Returns false when the result overflows the result precision.
+inline bool SparkDecimalAdd(__int128 a, __int128 b, const SparkArithParams &params, __int128 &result) {
+	if (__builtin_expect(params.drop == 0, 1)) {
+		__int128 scaled_a, scaled_b, sum;
+		if (!__builtin_mul_overflow(a, static_cast<__int128>(params.pow_a), &scaled_a) &&
+		    !__builtin_mul_overflow(b, static_cast<__int128>(params.pow_b), &scaled_b) &&
+		    !__builtin_add_overflow(scaled_a, scaled_b, &sum)) {
+			result = sum;
+			return Abs128(sum) < params.limit;
+		}
+	}
+	uint256_t mag_a = Mul128(Abs128(a), params.pow_a);
+	uint256_t mag_b = Mul128(Abs128(b), params.pow_b);
+	bool neg_a = a < 0;
+	bool neg_b = b < 0;
+	if (neg_a == neg_b) {
+		return SparkRoundToResult(Add256(mag_a, mag_b), neg_a, params, result);
+	}
+	if (LessThan256(mag_a, mag_b)) {
+		return SparkRoundToResult(Sub256(mag_b, mag_a), neg_b, params, result);
+	}
+	return SparkRoundToResult(Sub256(mag_a, mag_b), neg_a, params, result);
+}
+
+// a - b. |b| < 10^38, so negating it cannot overflow.
+inline bool SparkDecimalSubtract(__int128 a, __int128 b, const SparkArithParams &params, __int128 &result) {
+	return SparkDecimalAdd(a, -b, params, result);
+}
+
+// Bind data for spark_decimal_mul / spark_decimal_add / spark_decimal_sub.
+struct SparkArithBindData : public FunctionData {
+	SparkArithParams params;
+	bool ansi; // overflow raises an error instead of returning NULL
+
+	SparkArithBindData(const SparkArithParams &params_p, bool ansi_p) : params(params_p), ansi(ansi_p) {
+	}
+
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<SparkArithBindData>(params, ansi);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<SparkArithBindData>();
+		return params.limit == other.params.limit && params.pow_a == other.params.pow_a &&
+		       params.pow_b == other.params.pow_b && params.drop == other.params.drop && ansi == other.ansi;
+	}
+};
+
+// The DECIMAL overloads of the `*`, `+` and `-` operators are replaced for the
+// whole database when the extension loads, so every connection gets Spark
+// semantics for them. A connection that sets spark_decimal_operators to false
+// binds DuckDB's own DECIMAL implementation again.
+
+static constexpr const char *SPARK_DECIMAL_OPERATORS_SETTING = "spark_decimal_operators";
+
+// Registers spark_decimal_mul/add/sub, the operator overloads and their
+// setting (see spark_arithmetic.cpp).
+void RegisterSparkArithmeticFunctions(ExtensionLoader &loader);
+
+} // namespace duckdb
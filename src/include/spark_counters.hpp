@@ -0,0 +1,91 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+#include <atomic>
+
+namespace duckdb {
+
+class ExtensionLoader;
+
+// ---------------------------------------------------------------------------
+// Runtime counters for slow-path and edge-case hits
+// ---------------------------------------------------------------------------
+// Each thread owns one cache-line aligned block of counters, so updates are a
+// plain relaxed load + store on a line no other thread writes. Kernels add
+// per-vector totals, never per-row. thdck_spark_stats() sums the blocks of all
+// threads; blocks of exited threads are recycled with their counts intact.
+
+enum class SparkCounter : uint32_t {
+	DIV_ROWS,                  // rows evaluated by spark_decimal_div, `/`, div/%/pmod and spark_decimal_div_{eq,...}
+	DIV_WIDE_ROWS,             // dividends whose scaled value needed the 256-bit path
+	DIV_ZERO_DIVISOR_ROWS,     // rows that became NULL because the divisor was zero
+	DIV_CONSTANT_DIVISOR_ROWS, // rows divided through a precomputed reciprocal
+	DIV_OVERFLOW_ROWS,         // rows that became NULL because the quotient overflowed the result precision
+	DIV_DICTIONARY_ROWS,       // rows answered from dictionary entries that were each divided once
+	ARITH_ROWS,                // rows evaluated by spark_decimal_mul/add/sub and `*`, `+`, `-`
+	ARITH_OVERFLOW_ROWS,       // rows that became NULL because the result precision overflowed
+	AGG_NARROW_ROWS,           // rows aggregated by the int64 spark_sum/spark_avg states
+	AGG_WIDE_ROWS,             // rows aggregated by the hugeint_t spark_sum/spark_avg states
+	AGG_INTEGER_ROWS,          // rows aggregated by the integer spark_sum overloads
+	COUNT
+};
+
+static constexpr idx_t SPARK_COUNTER_COUNT = static_cast<idx_t>(SparkCounter::COUNT);
+
+struct alignas(64) SparkCounterBlock {
+	std::atomic<uint64_t> values[SPARK_COUNTER_COUNT];
+};
+
+SparkCounterBlock *AcquireSparkCounterBlock();
+void ReleaseSparkCounterBlock(SparkCounterBlock *block);
+
+// Owns the calling thread's block for the lifetime of the thread
+struct SparkCounterHandle {
+	SparkCounterBlock *block;
+
+	SparkCounterHandle() : block(AcquireSparkCounterBlock()) {
+	}
+	~SparkCounterHandle() {
+		ReleaseSparkCounterBlock(block);
+	}
+};
+
+inline SparkCounterBlock &LocalSparkCounters() {
+	thread_local SparkCounterHandle handle;
+	return *handle.block;
+}
+
+// Set while a kernel runs on stand-ins for rows (dictionary entries) and
+// counts the rows itself afterwards; see SparkCountersPause
+inline bool &SparkCountersPaused() {
+	thread_local bool paused = false;
+	return paused;
+}
+
+// Only the owning thread writes its block, so no read-modify-write is needed.
+// A concurrent reset may drop an in-flight update, which is acceptable here.
+inline void SparkCountAdd(SparkCounter counter, uint64_t amount) {
+	if (amount == 0 || SparkCountersPaused()) {
+		return;
+	}
+	auto &slot = LocalSparkCounters().values[static_cast<idx_t>(counter)];
+	slot.store(slot.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+// Drops the calling thread's counts while it lives
+struct SparkCountersPause {
+	bool previous;
+
+	SparkCountersPause() : previous(SparkCountersPaused()) {
+		SparkCountersPaused() = true;
+	}
+	~SparkCountersPause() {
+		SparkCountersPaused() = previous;
+	}
+};
+
+// Registers thdck_spark_stats() and thdck_spark_stats_reset()
+void RegisterSparkCounterFunctions(ExtensionLoader &loader);
+
+} // namespace duckdb
@@ -0,0 +1,274 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "wide_integer.hpp"
+
+#include <cstring>
+
+namespace duckdb {
+
+class ExtensionLoader;
+
+// ---------------------------------------------------------------------------
+// Spark-compatible VARCHAR <-> DECIMAL conversion on scaled integers
+// ---------------------------------------------------------------------------
+// Parsing follows Spark's CAST(string AS DECIMAL(p, s)): surrounding whitespace
+// and control characters are trimmed, the number may have a sign, a fraction
+// and an exponent ("1.5", "-.5", "5.", "+1.2E-3"), and the value is rounded to
+// scale s with ROUND_HALF_UP. Formatting is the plain form Spark returns for
+// CAST(decimal AS STRING): no exponent, exactly s fraction digits.
+
+enum class SparkDecimalParseResult : uint8_t { SUCCESS, INVALID_INPUT, OUT_OF_RANGE };
+
+inline bool SparkIsDigit(char c) {
+	return static_cast<uint8_t>(c - '0') < 10;
+}
+
+// 8 bytes as a little-endian word, so the first character is the low byte.
+inline uint64_t SparkLoad8(const char *p) {
+	uint64_t chunk;
+	memcpy(&chunk, p, sizeof(chunk));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	chunk = __builtin_bswap64(chunk);
+#endif
+	return chunk;
+}
+
+// SWAR: all 8 bytes are ASCII digits. A byte is a digit when its high nibble is
+// 3 and stays 3 after adding 6 ('9' + 6 = 0x3F, ':' + 6 = 0x40).
+inline bool SparkAllDigits8(uint64_t chunk) {
+	return ((chunk & 0xF0F0F0F0F0F0F0F0ULL) | (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+	       0x3333333333333333ULL;
+}
+
+// SWAR: value of 8 ASCII digits (first character most significant). Adjacent
+// digits are combined into 2-digit, then 4-digit, then 8-digit lanes with three
+// multiplies instead of eight multiply-adds.
+inline uint32_t SparkParse8Digits(uint64_t chunk) {
+	chunk -= 0x3030303030303030ULL;
+	chunk = (chunk * 10) + (chunk >> 8);
+	chunk = (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+	         (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >>
+	        32;
+	return static_cast<uint32_t>(chunk);
+}
+
+// End of the run of digits starting at p, 8 characters per step.
+inline const char *SparkScanDigits(const char *p, const char *end) {
+	while (end - p >= 8 && SparkAllDigits8(SparkLoad8(p))) {
+		p += 8;
+	}
+	while (p < end && SparkIsDigit(*p)) {
+		p++;
+	}
+	return p;
+}
+
+// value = value * 10^count + digits[0, count). The caller keeps the total at
+// 38 digits or fewer.
+inline void SparkAccumulateDigits(const char *digits, idx_t count, unsigned __int128 &value) {
+	for (; count >= 8; digits += 8, count -= 8) {
+		value = value * 100000000U + SparkParse8Digits(SparkLoad8(digits));
+	}
+	for (; count > 0; digits++, count--) {
+		value = value * 10 + static_cast<uint8_t>(*digits - '0');
+	}
+}
+
+// Exponents are clamped here; any larger one overflows or rounds to zero anyway.
+static constexpr int64_t SPARK_PARSE_MAX_EXPONENT = 1000000000;
+
+// Parse `str` as DECIMAL(precision, scale) into the scaled integer `result`.
+inline SparkDecimalParseResult SparkParseDecimal(const char *str, idx_t len, uint8_t precision, uint8_t scale,
+                                                 __int128 &result) {
+	const char *p = str;
+	const char *end = str + len;
+	while (p < end && static_cast<uint8_t>(*p) <= ' ') {
+		p++;
+	}
+	while (end > p && static_cast<uint8_t>(end[-1]) <= ' ') {
+		end--;
+	}
+
+	bool negative = false;
+	if (p < end && (*p == '+' || *p == '-')) {
+		negative = *p == '-';
+		p++;
+	}
+	const char *int_begin = p;
+	const char *int_end = SparkScanDigits(p, end);
+	const char *frac_begin = int_end;
+	const char *frac_end = int_end;
+	p = int_end;
+	if (p < end && *p == '.') {
+		frac_begin = p + 1;
+		frac_end = SparkScanDigits(frac_begin, end);
+		p = frac_end;
+	}
+	if (int_begin == int_end && frac_begin == frac_end) {
+		return SparkDecimalParseResult::INVALID_INPUT;
+	}
+
+	int64_t exponent = 0;
+	if (p < end && (*p == 'e' || *p == 'E')) {
+		p++;
+		bool exponent_negative = false;
+		if (p < end && (*p == '+' || *p == '-')) {
+			exponent_negative = *p == '-';
+			p++;
+		}
+		const char *exponent_begin = p;
+		for (; p < end && SparkIsDigit(*p); p++) {
+			if (exponent < SPARK_PARSE_MAX_EXPONENT) {
+				exponent = exponent * 10 + (*p - '0');
+			}
+		}
+		if (p == exponent_begin) {
+			return SparkDecimalParseResult::INVALID_INPUT;
+		}
+		exponent = exponent_negative ? -exponent : exponent;
+	}
+	if (p != end) {
+		return SparkDecimalParseResult::INVALID_INPUT;
+	}
+
+	// Value = digits * 10^(exponent - fraction digits), so the scaled integer is
+	// digits * 10^shift
+	int64_t shift = exponent - static_cast<int64_t>(frac_end - frac_begin) + scale;
+
+	// The digits form one logical sequence, integer part then fraction part;
+	// without its leading zeros, n significant digits remain.
+	while (int_begin < int_end && *int_begin == '0') {
+		int_begin++;
+	}
+	if (int_begin == int_end) {
+		while (frac_begin < frac_end && *frac_begin == '0') {
+			frac_begin++;
+		}
+	}
+	auto int_len = static_cast<idx_t>(int_end - int_begin);
+	auto n = static_cast<int64_t>(int_len + static_cast<idx_t>(frac_end - frac_begin));
+	// Appends the first `count` significant digits to `value`
+	auto accumulate = [&](idx_t count, unsigned __int128 &value) {
+		SparkAccumulateDigits(int_begin, MinValue<idx_t>(count, int_len), value);
+		if (count > int_len) {
+			SparkAccumulateDigits(frac_begin, count - int_len, value);
+		}
+	};
+
+	unsigned __int128 magnitude = 0;
+	if (n == 0) {
+		// zero
+	} else if (shift >= 0) {
+		// Exact: n + shift digits
+		if (n + shift > precision) {
+			return SparkDecimalParseResult::OUT_OF_RANGE;
+		}
+		accumulate(static_cast<idx_t>(n), magnitude);
+		magnitude *= Pow10_128(static_cast<uint32_t>(shift));
+	} else {
+		// Keep n + shift digits; HALF_UP rounds up when the first dropped digit is >= 5
+		int64_t kept = n + shift;
+		if (kept > precision) {
+			return SparkDecimalParseResult::OUT_OF_RANGE;
+		}
+		if (kept >= 0) {
+			accumulate(static_cast<idx_t>(kept), magnitude);
+			auto k = static_cast<idx_t>(kept);
+			char round_digit = k < int_len ? int_begin[k] : frac_begin[k - int_len];
+			magnitude += round_digit >= '5' ? 1 : 0;
+			if (magnitude >= Pow10_128(precision)) {
+				return SparkDecimalParseResult::OUT_OF_RANGE;
+			}
+		}
+	}
+	result = negative ? -static_cast<__int128>(magnitude) : static_cast<__int128>(magnitude);
+	return SparkDecimalParseResult::SUCCESS;
+}
+
+// ---------------------------------------------------------------------------
+// Formatting
+// ---------------------------------------------------------------------------
+
+static constexpr char SPARK_DIGIT_PAIRS[] = "00010203040506070809"
+                                            "10111213141516171819"
+                                            "20212223242526272829"
+                                            "30313233343536373839"
+                                            "40414243444546474849"
+                                            "50515253545556575859"
+                                            "60616263646566676869"
+                                            "70717273747576777879"
+                                            "80818283848586878889"
+                                            "90919293949596979899";
+
+// Write the digits of `value` right to left ending at `end`, two per step.
+// Returns the first digit.
+inline char *SparkFormatUnsigned(uint64_t value, char *end) {
+	while (value >= 100) {
+		auto pair = static_cast<idx_t>(value % 100) * 2;
+		value /= 100;
+		end -= 2;
+		memcpy(end, SPARK_DIGIT_PAIRS + pair, 2);
+	}
+	if (value >= 10) {
+		end -= 2;
+		memcpy(end, SPARK_DIGIT_PAIRS + value * 2, 2);
+	} else {
+		*--end = static_cast<char>('0' + value);
+	}
+	return end;
+}
+
+// Longest DECIMAL(38, s) string: sign, 38 digits, '.' and a leading "0" for s = 38
+static constexpr idx_t SPARK_DECIMAL_STRING_SIZE = 41;
+
+// Format the scaled integer `value` of a DECIMAL(p, scale) into `buffer` (at
+// least SPARK_DECIMAL_STRING_SIZE bytes). Returns the length.
+inline idx_t SparkFormatDecimal(__int128 value, uint8_t scale, char *buffer) {
+	unsigned __int128 magnitude = Abs128(value);
+	D_ASSERT(magnitude < Pow10_128(38));
+
+	char digits[40];
+	char *digits_end = digits + sizeof(digits);
+	char *first;
+	if ((magnitude >> 64) == 0) {
+		first = SparkFormatUnsigned(static_cast<uint64_t>(magnitude), digits_end);
+	} else {
+		// Split into 10^19 limbs: the high limb is below 10^19 since |value| < 10^38
+		static constexpr uint64_t POW10_19 = 10000000000000000000ULL;
+		uint64_t low;
+		uint64_t high = Div128By64(static_cast<uint64_t>(magnitude >> 64), static_cast<uint64_t>(magnitude),
+		                           POW10_19, &low);
+		char *low_begin = SparkFormatUnsigned(low, digits_end);
+		char *high_end = digits_end - 19;
+		memset(high_end, '0', static_cast<idx_t>(low_begin - high_end));
+		first = SparkFormatUnsigned(high, high_end);
+	}
+	// At least one integer digit: 0.05 at scale 2 is "0.05"
+	auto digit_count = static_cast<idx_t>(digits_end - first);
+	if (digit_count < static_cast<idx_t>(scale) + 1) {
+		idx_t pad = scale + 1 - digit_count;
+		first -= pad;
+		memset(first, '0', pad);
+		digit_count += pad;
+	}
+
+	char *out = buffer;
+	if (value < 0) {
+		*out++ = '-';
+	}
+	idx_t int_digits = digit_count - scale;
+	memcpy(out, first, int_digits);
+	out += int_digits;
+	if (scale > 0) {
+		*out++ = '.';
+		memcpy(out, first + int_digits, scale);
+		out += scale;
+	}
+	return static_cast<idx_t>(out - buffer);
+}
+
+// Registers spark_cast_decimal and spark_decimal_to_string (see spark_cast.cpp).
+void RegisterSparkCastFunctions(ExtensionLoader &loader);
+
+} // namespace duckdb
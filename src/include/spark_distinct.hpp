@@ -0,0 +1,368 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "spark_aggregates.hpp"
+
+namespace duckdb {
+
+// ============================================================================
+// spark_sum_distinct / spark_avg_distinct: DECIMAL SUM(DISTINCT x), AVG(DISTINCT x)
+//
+// Each group keeps an open-addressing hash set of the scaled integers in
+// their native width (int64 for p <= 18, hugeint_t otherwise), so no DECIMAL(38)
+// copies are materialized and no second aggregation pass is needed. The sets
+// are allocated from the aggregate's arena, so no destructor runs. Combine
+// merges the sets; finalize sums the distinct values and reuses the
+// spark_sum / spark_avg finalize (result types and HALF_UP rounding match).
+// ============================================================================
+
+// Linear-probing set whose header and slots live in the aggregate's arena.
+// 0 marks an empty slot, so the key 0 is tracked by a flag. Growing leaves the
+// old slots in the arena, which frees them with everything else; they add at
+// most the size of the final table.
+template <class KEY>
+struct SparkDistinctSet {
+	static constexpr idx_t INITIAL_CAPACITY = 16;
+
+	KEY *slots;     // capacity entries, kept at most 3/4 full
+	idx_t capacity; // power of two, 0 until the first non-zero key
+	idx_t size;     // non-zero keys in slots
+	bool has_zero;
+
+	static SparkDistinctSet *Create(ArenaAllocator &allocator) {
+		auto set = reinterpret_cast<SparkDistinctSet *>(allocator.AllocateAligned(sizeof(SparkDistinctSet)));
+		set->slots = nullptr;
+		set->capacity = 0;
+		set->size = 0;
+		set->has_zero = false;
+		return set;
+	}
+
+	static SparkDistinctSet *Copy(ArenaAllocator &allocator, const SparkDistinctSet &other) {
+		auto set = Create(allocator);
+		set->has_zero = other.has_zero;
+		if (other.capacity > 0) {
+			set->slots = AllocateSlots(allocator, other.capacity);
+			memcpy(set->slots, other.slots, other.capacity * sizeof(KEY));
+			set->capacity = other.capacity;
+			set->size = other.size;
+		}
+		return set;
+	}
+
+	idx_t Count() const {
+		return size + (has_zero ? 1 : 0);
+	}
+
+	void Insert(ArenaAllocator &allocator, const KEY &key) {
+		if (key == KEY(0)) {
+			has_zero = true;
+			return;
+		}
+		if ((size + 1) * 4 > capacity * 3) {
+			Grow(allocator);
+		}
+		InsertNonZero(key);
+	}
+
+	void Merge(ArenaAllocator &allocator, const SparkDistinctSet &other) {
+		has_zero |= other.has_zero;
+		for (idx_t i = 0; i < other.capacity; i++) {
+			if (!(other.slots[i] == KEY(0))) {
+				Insert(allocator, other.slots[i]);
+			}
+		}
+	}
+
+	template <class FUNC>
+	void ForEach(FUNC &&fun) const {
+		if (has_zero) {
+			fun(KEY(0));
+		}
+		for (idx_t i = 0; i < capacity; i++) {
+			if (!(slots[i] == KEY(0))) {
+				fun(slots[i]);
+			}
+		}
+	}
+
+private:
+	// All-zero bytes are KEY(0) for both int64_t and hugeint_t
+	static KEY *AllocateSlots(ArenaAllocator &allocator, idx_t count) {
+		auto result = reinterpret_cast<KEY *>(allocator.AllocateAligned(count * sizeof(KEY)));
+		memset(result, 0, count * sizeof(KEY));
+		return result;
+	}
+
+	void InsertNonZero(const KEY &key) {
+		idx_t mask = capacity - 1;
+		for (idx_t pos = Hash(key) & mask;; pos = (pos + 1) & mask) {
+			if (slots[pos] == KEY(0)) {
+				slots[pos] = key;
+				size++;
+				return;
+			}
+			if (slots[pos] == key) {
+				return;
+			}
+		}
+	}
+
+	void Grow(ArenaAllocator &allocator) {
+		auto old_slots = slots;
+		auto old_capacity = capacity;
+		capacity = old_capacity == 0 ? INITIAL_CAPACITY : old_capacity * 2;
+		slots = AllocateSlots(allocator, capacity);
+		size = 0;
+		for (idx_t i = 0; i < old_capacity; i++) {
+			if (!(old_slots[i] == KEY(0))) {
+				InsertNonZero(old_slots[i]);
+			}
+		}
+	}
+};
+
+template <class KEY>
+struct SparkDistinctState {
+	SparkDistinctSet<KEY> *set;
+};
+
+// Input -> stored key. int64 keys hold any DECIMAL(p <= 18) value, and hugeint_t
+// values proven by statistics to fit in int64.
+template <class KEY>
+struct SparkDistinctKey;
+
+template <>
+struct SparkDistinctKey<int64_t> {
+	template <class INPUT_TYPE>
+	static int64_t Get(const INPUT_TYPE &input) {
+		return DecimalToInt64(input);
+	}
+};
+
+template <>
+struct SparkDistinctKey<hugeint_t> {
+	static hugeint_t Get(const hugeint_t &input) {
+		return input;
+	}
+};
+
+template <typename INPUT_TYPE>
+struct SparkDistinctKeyFor {
+	using type = int64_t;
+};
+
+template <>
+struct SparkDistinctKeyFor<hugeint_t> {
+	using type = hugeint_t;
+};
+
+// Sum and count of the distinct values, in the shape the spark_sum and
+// spark_avg finalize functions read.
+struct SparkDistinctTotals {
+	__int128 sum = 0;
+	uint64_t count = 0;
+	bool isset = false;
+
+	void Add(int64_t key) {
+		// At most 2^64 distinct int64 values: the sum cannot exceed 2^127
+		sum += key;
+	}
+
+	void Add(const hugeint_t &key) {
+		if (__builtin_add_overflow(sum, HugeintToInt128(key), &sum)) {
+			throw OutOfRangeException("Overflow in HUGEINT addition");
+		}
+	}
+
+	__int128 Value() const {
+		return sum;
+	}
+
+	__int128 Sum() const {
+		return sum;
+	}
+};
+
+// FINALIZE_OP is SparkSumDecimalOperation<RESULT_TYPE> or SparkAvgDecimalOperation<RESULT_TYPE>
+template <class KEY, class FINALIZE_OP>
+struct SparkDistinctDecimalOperation {
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.set = nullptr;
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &unary_input) {
+		auto &allocator = unary_input.input.allocator;
+		if (!state.set) {
+			state.set = SparkDistinctSet<KEY>::Create(allocator);
+		}
+		state.set->Insert(allocator, SparkDistinctKey<KEY>::Get(input));
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &unary_input, idx_t) {
+		Operation<INPUT_TYPE, STATE, OP>(state, input, unary_input);
+	}
+
+	template <class STATE, class OP>
+	static void Combine(const STATE &source, STATE &target, AggregateInputData &aggr_input_data) {
+		if (!source.set) {
+			return;
+		}
+		bool destructive = aggr_input_data.combine_type == AggregateCombineType::ALLOW_DESTRUCTIVE;
+		if (!target.set) {
+			if (destructive) {
+				target.set = source.set;
+				const_cast<STATE &>(source).set = nullptr;
+			} else {
+				target.set = SparkDistinctSet<KEY>::Copy(aggr_input_data.allocator, *source.set);
+			}
+			return;
+		}
+		if (destructive && source.set->size > target.set->size) {
+			// Merge the smaller set into the larger one
+			std::swap(target.set, const_cast<STATE &>(source).set);
+		}
+		target.set->Merge(aggr_input_data.allocator, *source.set);
+	}
+
+	template <class T, class STATE>
+	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
+		SparkDistinctTotals totals;
+		if (state.set) {
+			state.set->ForEach([&](const KEY &key) { totals.Add(key); });
+			totals.count = state.set->Count();
+			totals.isset = totals.count > 0;
+		}
+		FINALIZE_OP::template Finalize<T>(totals, target, finalize_data);
+	}
+
+	static bool IgnoreNull() {
+		return true;
+	}
+};
+
+// ----------------------------------------------------------------------------
+// Implementation selection, mirroring GetSparkSumDecimalFunction
+// ----------------------------------------------------------------------------
+
+template <template <typename> class FINALIZE_OP, typename INPUT_TYPE, typename RESULT_TYPE, typename KEY>
+static AggregateFunction GetSparkDistinctDecimalImplementation() {
+	using OP = SparkDistinctDecimalOperation<KEY, FINALIZE_OP<RESULT_TYPE>>;
+	return AggregateFunction::UnaryAggregate<SparkDistinctState<KEY>, INPUT_TYPE, RESULT_TYPE, OP>(
+	    LogicalType::DECIMAL(38, 0), LogicalType::DECIMAL(38, 0));
+}
+
+template <template <typename> class FINALIZE_OP, typename INPUT_TYPE,
+          typename KEY = typename SparkDistinctKeyFor<INPUT_TYPE>::type>
+static AggregateFunction GetSparkDistinctDecimalFunction(PhysicalType result_type) {
+	switch (result_type) {
+	case PhysicalType::INT16:
+		return GetSparkDistinctDecimalImplementation<FINALIZE_OP, INPUT_TYPE, int16_t, KEY>();
+	case PhysicalType::INT32:
+		return GetSparkDistinctDecimalImplementation<FINALIZE_OP, INPUT_TYPE, int32_t, KEY>();
+	case PhysicalType::INT64:
+		return GetSparkDistinctDecimalImplementation<FINALIZE_OP, INPUT_TYPE, int64_t, KEY>();
+	case PhysicalType::INT128:
+		return GetSparkDistinctDecimalImplementation<FINALIZE_OP, INPUT_TYPE, hugeint_t, KEY>();
+	default:
+		throw InternalException("Unexpected physical type for DISTINCT DECIMAL result");
+	}
+}
+
+template <template <typename> class FINALIZE_OP>
+static AggregateFunction GetSparkDistinctDecimalFunction(PhysicalType input_type, PhysicalType result_type) {
+	switch (input_type) {
+	case PhysicalType::INT16:
+		return GetSparkDistinctDecimalFunction<FINALIZE_OP, int16_t>(result_type);
+	case PhysicalType::INT32:
+		return GetSparkDistinctDecimalFunction<FINALIZE_OP, int32_t>(result_type);
+	case PhysicalType::INT64:
+		return GetSparkDistinctDecimalFunction<FINALIZE_OP, int64_t>(result_type);
+	case PhysicalType::INT128:
+		return GetSparkDistinctDecimalFunction<FINALIZE_OP, hugeint_t>(result_type);
+	default:
+		throw InternalException("Unexpected physical type for DISTINCT DECIMAL input");
+	}
+}
+
+static unique_ptr<FunctionData> BindSparkSumDistinctDecimal(ClientContext &context, AggregateFunction &function,
+                                                             vector<unique_ptr<Expression>> &arguments) {
+	auto &type = arguments[0]->return_type;
+	if (type.id() != LogicalTypeId::DECIMAL) {
+		throw InvalidInputException("spark_sum_distinct requires DECIMAL argument");
+	}
+
+	uint8_t p = DecimalType::GetWidth(type);
+	uint8_t s = DecimalType::GetScale(type);
+	auto result = ComputeSumType(p, s);
+	auto result_type = LogicalType::DECIMAL(result.precision, result.scale);
+
+	SetSparkAggregateImplementation(function, GetSparkDistinctDecimalFunction<SparkSumDecimalOperation>(
+	                                              type.InternalType(), result_type.InternalType()));
+	function.arguments[0] = type;
+	function.return_type = result_type;
+
+	return make_uniq<SparkAggBindData>(s, result, SparkAnsiEnabled(context));
+}
+
+static unique_ptr<FunctionData> BindSparkAvgDistinctDecimal(ClientContext &context, AggregateFunction &function,
+                                                             vector<unique_ptr<Expression>> &arguments) {
+	auto &type = arguments[0]->return_type;
+	if (type.id() != LogicalTypeId::DECIMAL) {
+		throw InvalidInputException("spark_avg_distinct requires DECIMAL argument");
+	}
+
+	uint8_t p = DecimalType::GetWidth(type);
+	uint8_t s = DecimalType::GetScale(type);
+	auto result = ComputeAvgType(p, s);
+	auto result_type = LogicalType::DECIMAL(result.precision, result.scale);
+
+	SetSparkAggregateImplementation(function, GetSparkDistinctDecimalFunction<SparkAvgDecimalOperation>(
+	                                              type.InternalType(), result_type.InternalType()));
+	function.arguments[0] = type;
+	function.return_type = result_type;
+
+	return make_uniq<SparkAggBindData>(s, result, SparkAnsiEnabled(context));
+}
+
+// Statistics: hugeint_t inputs whose values fit in int64 store int64 keys,
+// halving the set's memory.
+template <template <typename> class FINALIZE_OP>
+static unique_ptr<BaseStatistics> SparkDistinctDecimalStats(ClientContext &context, BoundAggregateExpression &expr,
+                                                            AggregateStatisticsInput &input) {
+	__int128 min_val, max_val;
+	if (!TryGetDecimalStatsBounds(input.child_stats[0], min_val, max_val)) {
+		return nullptr;
+	}
+	if (expr.children[0]->return_type.InternalType() == PhysicalType::INT128 && BoundsFitInt64(min_val, max_val)) {
+		SetSparkAggregateImplementation(expr.function, GetSparkDistinctDecimalFunction<FINALIZE_OP, hugeint_t, int64_t>(
+		                                                   expr.function.return_type.InternalType()));
+	}
+	return nullptr;
+}
+
+inline AggregateFunctionSet CreateSparkSumDistinctFunctionSet() {
+	AggregateFunctionSet set("spark_sum_distinct");
+	auto decimal_func = GetSparkDistinctDecimalFunction<SparkSumDecimalOperation, hugeint_t>(PhysicalType::INT128);
+	decimal_func.bind = BindSparkSumDistinctDecimal;
+	decimal_func.statistics = SparkDistinctDecimalStats<SparkSumDecimalOperation>;
+	decimal_func.order_dependent = AggregateOrderDependent::NOT_ORDER_DEPENDENT;
+	set.AddFunction(decimal_func);
+	return set;
+}
+
+inline AggregateFunctionSet CreateSparkAvgDistinctFunctionSet() {
+	AggregateFunctionSet set("spark_avg_distinct");
+	auto decimal_func = GetSparkDistinctDecimalFunction<SparkAvgDecimalOperation, hugeint_t>(PhysicalType::INT128);
+	decimal_func.bind = BindSparkAvgDistinctDecimal;
+	decimal_func.statistics = SparkDistinctDecimalStats<SparkAvgDecimalOperation>;
+	decimal_func.order_dependent = AggregateOrderDependent::NOT_ORDER_DEPENDENT;
+	set.AddFunction(decimal_func);
+	return set;
+}
+
+} // namespace duckdb
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "wide_integer.hpp"
+#include "decimal_division.hpp"
+#include "spark_precision.hpp"
+
+namespace duckdb {
+
+class ExtensionLoader;
+
+// ---------------------------------------------------------------------------
+// spark_decimal_div(a, b) compared without computing the quotient
+// ---------------------------------------------------------------------------
+// spark_decimal_div_{eq,ne,lt,le,gt,ge}(a, b, c) is spark_decimal_div(a, b)
+// =, <>, <, <=, >, >= c, with c taken as DECIMAL(38, s) at the quotient's
+// scale s. Each row decides q >= c (and q >= c + 1) by comparing
+// 2 |a| 10^scale_adj with (2c - 1) |b| (SparkQuotientAtLeast), so no 128- or
+// 256-bit division runs; only a scale_adj above 38, where that product can
+// exceed 256 bits, computes the quotient. NULL inputs, zero divisors and
+// quotients outside the result precision behave as for the division itself:
+// the row is NULL, and an overflow raises in ANSI mode even when c is NULL.
+//
+// The division comparison optimizer rule (spark_optimizer.cpp) rewrites
+// comparisons of a division result with a constant into these functions.
+//
+// Scope: DuckDB scalar functions have no selection-vector callback, so in a
+// WHERE clause these run like any BOOLEAN function: the executor passes only
+// the rows still selected, the kernel writes a BOOLEAN vector, and the
+// executor's default select turns it into the selection vector. What is
+// skipped is the division, not the BOOLEAN result.
+
+struct SparkDivCompareBindData : public FunctionData {
+	uint32_t scale_adj; // result_scale - s1 + s2
+	SparkDecimalResult result;
+	// The quotient may exceed the result precision (p1 + scale_adj > result
+	// precision), so each row is range checked first
+	bool check_range;
+	bool ansi;
+
+	SparkDivCompareBindData(uint32_t scale_adj_p, const SparkDecimalResult &result_p, bool check_range_p, bool ansi_p)
+	    : scale_adj(scale_adj_p), result(result_p), check_range(check_range_p), ansi(ansi_p) {
+	}
+
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<SparkDivCompareBindData>(scale_adj, result, check_range, ansi);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<SparkDivCompareBindData>();
+		return scale_adj == other.scale_adj && result.precision == other.result.precision &&
+		       result.scale == other.result.scale && check_range == other.check_range && ansi == other.ansi;
+	}
+};
+
+// The function for a comparison expression type (COMPARE_EQUAL,
+// COMPARE_NOTEQUAL, COMPARE_LESSTHAN, COMPARE_GREATERTHAN,
+// COMPARE_LESSTHANOREQUALTO or COMPARE_GREATERTHANOREQUALTO).
+ScalarFunction GetSparkDivCompareFunction(ExpressionType comparison);
+
+// Registers spark_decimal_div_eq, _ne, _lt, _le, _gt and _ge (see
+// spark_div_compare.cpp).
+void RegisterSparkDivCompareFunctions(ExtensionLoader &loader);
+
+} // namespace duckdb
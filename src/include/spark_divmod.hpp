@@ -0,0 +1,131 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "wide_integer.hpp"
+#include "decimal_division.hpp"
+#include "spark_precision.hpp"
+
+namespace duckdb {
+
+class ExtensionLoader;
+
+// ---------------------------------------------------------------------------
+// Spark DECIMAL integral divide (`div`), remainder (`%`) and pmod
+// ---------------------------------------------------------------------------
+// Both operands are aligned to the common scale max(s1, s2); one truncated
+// SparkDecimalDivMod of the aligned values yields the quotient or the
+// remainder directly:
+//   div:  trunc(a / b) as BIGINT
+//   %:    a - trunc(a / b) * b, with the sign of a
+//   pmod: the remainder, plus b when it is negative and b is positive
+// Only the operand with the smaller scale is scaled. A divisor that no longer
+// fits in 128 bits exceeds every dividend, so the quotient is 0 and the
+// remainder is the dividend. Division by zero is NULL (checked by the caller),
+// and a result that does not fit is NULL, or an error in ANSI mode.
+//
+// Deviation: outside ANSI mode Spark's div converts the quotient with
+// BigDecimal.longValue, which keeps the low 64 bits, so a quotient outside
+// the BIGINT range wraps. Here it is NULL instead, as for % and pmod.
+
+// Per-query parameters, precomputed at bind time.
+struct SparkDivModParams {
+	unsigned __int128 pow_a; // 10^(max(s1, s2) - s1), or 0 when s1 >= s2 (SparkDecimalDivide contract)
+	unsigned __int128 pow_b; // 10^(max(s1, s2) - s2)
+	unsigned __int128 limit; // |result| must stay below it: 10^result_precision, or 2^63 for div
+};
+
+inline SparkDivModParams MakeSparkDivModParams(uint8_t s1, uint8_t s2, unsigned __int128 limit) {
+	uint8_t common_scale = std::max(s1, s2);
+	return {common_scale > s1 ? Pow10_128(common_scale - s1) : 0, Pow10_128(common_scale - s2), limit};
+}
+
+// |b| at the common scale. Returns false when it needs more than 128 bits.
+inline bool SparkAlignDivisor(__int128 b, const SparkDivModParams &params, unsigned __int128 &abs_b) {
+	abs_b = Abs128(b);
+	return params.pow_b == 1 || !__builtin_mul_overflow(abs_b, params.pow_b, &abs_b);
+}
+
+// div: BIGINT quotient, truncated toward zero. b must be non-zero. Returns
+// false when the quotient is outside the BIGINT range (NULL, where Spark wraps).
+inline bool SparkDecimalIntegralDivide(__int128 a, __int128 b, const SparkDivModParams &params, __int128 &result) {
+	unsigned __int128 abs_b;
+	if (!SparkAlignDivisor(b, params, abs_b)) {
+		result = 0;
+		return true;
+	}
+	unsigned __int128 quotient, remainder;
+	if (!SparkDecimalDivMod(Abs128(a), params.pow_a, abs_b, quotient, remainder)) {
+		return false;
+	}
+	bool negative = (a < 0) != (b < 0);
+	// -2^63 is the one quotient whose magnitude reaches the limit
+	if (quotient >= params.limit + negative) {
+		return false;
+	}
+	result = negative ? -static_cast<__int128>(quotient) : static_cast<__int128>(quotient);
+	return true;
+}
+
+// Signed remainder at the common scale; the sign follows a. b must be non-zero.
+// `abs_b` is the aligned divisor, 0 when it does not fit in 128 bits.
+inline __int128 SparkDecimalAlignedRemainder(__int128 a, __int128 b, const SparkDivModParams &params,
+                                             unsigned __int128 &abs_b) {
+	if (!SparkAlignDivisor(b, params, abs_b)) {
+		abs_b = 0;
+		return a; // pow_a is 0 here: only the divisor was scaled
+	}
+	unsigned __int128 quotient, remainder;
+	SparkDecimalDivMod(Abs128(a), params.pow_a, abs_b, quotient, remainder);
+	return a < 0 ? -static_cast<__int128>(remainder) : static_cast<__int128>(remainder);
+}
+
+// %: |a % b| <= min(|a|, |b|) at the common scale, which always fits the result type.
+inline bool SparkDecimalRemainder(__int128 a, __int128 b, const SparkDivModParams &params, __int128 &result) {
+	unsigned __int128 abs_b;
+	result = SparkDecimalAlignedRemainder(a, b, params, abs_b);
+	return true;
+}
+
+// pmod: (a % b + b) % b, i.e. the remainder is moved into [0, b) when b > 0.
+// The shifted value |b| - |r| can exceed the result precision.
+inline bool SparkDecimalPmod(__int128 a, __int128 b, const SparkDivModParams &params, __int128 &result) {
+	unsigned __int128 abs_b;
+	result = SparkDecimalAlignedRemainder(a, b, params, abs_b);
+	if (result >= 0 || b < 0) {
+		return true;
+	}
+	if (abs_b == 0) {
+		return false; // |b| >= 2^128 at the common scale
+	}
+	unsigned __int128 shifted = abs_b - Abs128(result);
+	if (shifted >= params.limit) {
+		return false;
+	}
+	result = static_cast<__int128>(shifted);
+	return true;
+}
+
+// Bind data for spark_decimal_intdiv / spark_decimal_mod / spark_decimal_pmod.
+struct SparkDivModBindData : public FunctionData {
+	SparkDivModParams params;
+	bool ansi; // overflow raises an error instead of returning NULL
+
+	SparkDivModBindData(const SparkDivModParams &params_p, bool ansi_p) : params(params_p), ansi(ansi_p) {
+	}
+
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<SparkDivModBindData>(params, ansi);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<SparkDivModBindData>();
+		return params.pow_a == other.params.pow_a && params.pow_b == other.params.pow_b &&
+		       params.limit == other.params.limit && ansi == other.ansi;
+	}
+};
+
+// Registers spark_decimal_intdiv, spark_decimal_mod and spark_decimal_pmod
+// (see spark_divmod.cpp).
+void RegisterSparkDivModFunctions(ExtensionLoader &loader);
+
+} // namespace duckdb
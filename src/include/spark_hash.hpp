@@ -0,0 +1,251 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "wide_integer.hpp"
+
+#include <cstring>
+
+namespace duckdb {
+
+class ExtensionLoader;
+
+// ---------------------------------------------------------------------------
+// Spark's hash functions: Murmur3_x86_32 (hash) and XXH64 (xxhash64)
+// ---------------------------------------------------------------------------
+// Spark hashes a DECIMAL(p <= 18) as its unscaled long (8 bytes) and a wider
+// DECIMAL as the bytes of java.math.BigInteger#toByteArray: the shortest
+// big-endian two's complement encoding of the unscaled value. Physical INT128
+// is exactly p > 18.
+
+// Writes the BigInteger#toByteArray encoding of `value` to the end of `bytes`
+// and returns the index of its first byte.
+inline idx_t SparkBigIntegerBytes(__int128 value, uint8_t (&bytes)[16]) {
+	auto bits = static_cast<unsigned __int128>(value);
+	for (idx_t i = 0; i < 16; i++) {
+		bytes[15 - i] = static_cast<uint8_t>(bits >> (8 * i));
+	}
+	// Drop sign-extension bytes, keeping the sign bit in the first byte
+	idx_t start = 0;
+	while (start < 15 && ((bytes[start] == 0x00 && !(bytes[start + 1] & 0x80)) ||
+	                      (bytes[start] == 0xFF && (bytes[start + 1] & 0x80)))) {
+		start++;
+	}
+	return start;
+}
+
+// ---------------------------------------------------------------------------
+// XXH64 (org.apache.spark.sql.catalyst.expressions.XXH64): the standard
+// algorithm over little-endian input
+// ---------------------------------------------------------------------------
+
+static constexpr uint64_t SPARK_XXH_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+static constexpr uint64_t SPARK_XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+static constexpr uint64_t SPARK_XXH_PRIME64_3 = 0x165667B19E3779F9ULL;
+static constexpr uint64_t SPARK_XXH_PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+static constexpr uint64_t SPARK_XXH_PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+// Seed of approx_count_distinct (HyperLogLogPlusPlus)
+static constexpr uint64_t SPARK_HLL_SEED = 42;
+
+struct SparkXxHash64 {
+	typedef uint64_t hash_t;
+
+	static inline uint64_t Rotl(uint64_t x, uint32_t r) {
+		return (x << r) | (x >> (64 - r));
+	}
+
+	static inline uint64_t Load64(const uint8_t *p) {
+		uint64_t value = 0;
+		for (idx_t i = 0; i < 8; i++) {
+			value |= static_cast<uint64_t>(p[i]) << (8 * i);
+		}
+		return value;
+	}
+
+	static inline uint64_t Load32(const uint8_t *p) {
+		uint64_t value = 0;
+		for (idx_t i = 0; i < 4; i++) {
+			value |= static_cast<uint64_t>(p[i]) << (8 * i);
+		}
+		return value;
+	}
+
+	static inline uint64_t Round(uint64_t acc, uint64_t input) {
+		return Rotl(acc + input * SPARK_XXH_PRIME64_2, 31) * SPARK_XXH_PRIME64_1;
+	}
+
+	static inline uint64_t MergeRound(uint64_t acc, uint64_t value) {
+		return (acc ^ Round(0, value)) * SPARK_XXH_PRIME64_1 + SPARK_XXH_PRIME64_4;
+	}
+
+	static inline uint64_t Avalanche(uint64_t hash) {
+		hash ^= hash >> 33;
+		hash *= SPARK_XXH_PRIME64_2;
+		hash ^= hash >> 29;
+		hash *= SPARK_XXH_PRIME64_3;
+		hash ^= hash >> 32;
+		return hash;
+	}
+
+	static uint64_t Hash(const uint8_t *data, idx_t length, uint64_t seed) {
+		const uint8_t *end = data + length;
+		uint64_t hash;
+		if (length >= 32) {
+			uint64_t v1 = seed + SPARK_XXH_PRIME64_1 + SPARK_XXH_PRIME64_2;
+			uint64_t v2 = seed + SPARK_XXH_PRIME64_2;
+			uint64_t v3 = seed;
+			uint64_t v4 = seed - SPARK_XXH_PRIME64_1;
+			for (; data + 32 <= end; data += 32) {
+				v1 = Round(v1, Load64(data));
+				v2 = Round(v2, Load64(data + 8));
+				v3 = Round(v3, Load64(data + 16));
+				v4 = Round(v4, Load64(data + 24));
+			}
+			hash = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+			hash = MergeRound(hash, v1);
+			hash = MergeRound(hash, v2);
+			hash = MergeRound(hash, v3);
+			hash = MergeRound(hash, v4);
+		} else {
+			hash = seed + SPARK_XXH_PRIME64_5;
+		}
+		hash += length;
+		for (; data + 8 <= end; data += 8) {
+			hash = Rotl(hash ^ Round(0, Load64(data)), 27) * SPARK_XXH_PRIME64_1 + SPARK_XXH_PRIME64_4;
+		}
+		if (data + 4 <= end) {
+			hash = Rotl(hash ^ (Load32(data) * SPARK_XXH_PRIME64_1), 23) * SPARK_XXH_PRIME64_2 + SPARK_XXH_PRIME64_3;
+			data += 4;
+		}
+		for (; data < end; data++) {
+			hash = Rotl(hash ^ (*data * SPARK_XXH_PRIME64_5), 11) * SPARK_XXH_PRIME64_1;
+		}
+		return Avalanche(hash);
+	}
+
+	// XXH64.hashLong
+	static inline uint64_t HashLong(int64_t value, uint64_t seed) {
+		uint64_t hash = seed + SPARK_XXH_PRIME64_5 + 8;
+		hash ^= Round(0, static_cast<uint64_t>(value));
+		return Avalanche(Rotl(hash, 27) * SPARK_XXH_PRIME64_1 + SPARK_XXH_PRIME64_4);
+	}
+
+	// XXH64.hashInt
+	static inline uint64_t HashInt(int32_t value, uint64_t seed) {
+		uint64_t hash = seed + SPARK_XXH_PRIME64_5 + 4;
+		hash ^= static_cast<uint64_t>(static_cast<uint32_t>(value)) * SPARK_XXH_PRIME64_1;
+		return Avalanche(Rotl(hash, 23) * SPARK_XXH_PRIME64_2 + SPARK_XXH_PRIME64_3);
+	}
+
+	// XXH64.hashUnsafeBytes of BigInteger#toByteArray
+	static inline uint64_t HashBigInteger(__int128 value, uint64_t seed) {
+		uint8_t bytes[16];
+		auto start = SparkBigIntegerBytes(value, bytes);
+		return Hash(bytes + start, 16 - start, seed);
+	}
+
+	template <typename T>
+	static inline uint64_t HashDecimal(const T &value, uint64_t seed) {
+		return HashLong(static_cast<int64_t>(value), seed);
+	}
+};
+
+template <>
+inline uint64_t SparkXxHash64::HashDecimal<hugeint_t>(const hugeint_t &value, uint64_t seed) {
+	return HashBigInteger(HugeintToInt128(value), seed);
+}
+
+// ---------------------------------------------------------------------------
+// Murmur3_x86_32 (org.apache.spark.unsafe.hash.Murmur3_x86_32), on Java int
+// arithmetic. Byte arrays use Spark's hashUnsafeBytes, which differs from the
+// reference algorithm in the tail: each trailing byte is sign-extended and
+// mixed as a full block.
+// ---------------------------------------------------------------------------
+
+static constexpr uint32_t SPARK_MURMUR3_C1 = 0xCC9E2D51U;
+static constexpr uint32_t SPARK_MURMUR3_C2 = 0x1B873593U;
+
+struct SparkMurmur3 {
+	typedef int32_t hash_t;
+
+	static inline uint32_t Rotl(uint32_t x, uint32_t r) {
+		return (x << r) | (x >> (32 - r));
+	}
+
+	static inline uint32_t MixK1(uint32_t k1) {
+		return Rotl(k1 * SPARK_MURMUR3_C1, 15) * SPARK_MURMUR3_C2;
+	}
+
+	static inline uint32_t MixH1(uint32_t h1, uint32_t k1) {
+		return Rotl(h1 ^ k1, 13) * 5 + 0xE6546B64U;
+	}
+
+	static inline int32_t Fmix(uint32_t h1, uint32_t length) {
+		h1 ^= length;
+		h1 ^= h1 >> 16;
+		h1 *= 0x85EBCA6BU;
+		h1 ^= h1 >> 13;
+		h1 *= 0xC2B2AE35U;
+		h1 ^= h1 >> 16;
+		return static_cast<int32_t>(h1);
+	}
+
+	static inline int32_t HashInt(int32_t value, int32_t seed) {
+		return Fmix(MixH1(static_cast<uint32_t>(seed), MixK1(static_cast<uint32_t>(value))), 4);
+	}
+
+	static inline int32_t HashLong(int64_t value, int32_t seed) {
+		auto bits = static_cast<uint64_t>(value);
+		uint32_t h1 = MixH1(static_cast<uint32_t>(seed), MixK1(static_cast<uint32_t>(bits)));
+		h1 = MixH1(h1, MixK1(static_cast<uint32_t>(bits >> 32)));
+		return Fmix(h1, 8);
+	}
+
+	// Murmur3_x86_32.hashUnsafeBytes
+	static int32_t Hash(const uint8_t *data, idx_t length, int32_t seed) {
+		auto h1 = static_cast<uint32_t>(seed);
+		idx_t aligned = length - length % 4;
+		for (idx_t i = 0; i < aligned; i += 4) {
+			uint32_t block = static_cast<uint32_t>(data[i]) | static_cast<uint32_t>(data[i + 1]) << 8 |
+			                 static_cast<uint32_t>(data[i + 2]) << 16 | static_cast<uint32_t>(data[i + 3]) << 24;
+			h1 = MixH1(h1, MixK1(block));
+		}
+		for (idx_t i = aligned; i < length; i++) {
+			h1 = MixH1(h1, MixK1(static_cast<uint32_t>(static_cast<int32_t>(static_cast<int8_t>(data[i])))));
+		}
+		return Fmix(h1, static_cast<uint32_t>(length));
+	}
+
+	static inline int32_t HashBigInteger(__int128 value, int32_t seed) {
+		uint8_t bytes[16];
+		auto start = SparkBigIntegerBytes(value, bytes);
+		return Hash(bytes + start, 16 - start, seed);
+	}
+};
+
+// Bind data for spark_hash / spark_xxhash64: one kernel per argument, chosen by
+// its type and physical width. A kernel folds its column into the running
+// per-row hashes, each row's hash being the seed of the next column.
+template <typename HASHER>
+struct SparkHashBindData : public FunctionData {
+	typedef void (*column_function_t)(Vector &input, idx_t count, typename HASHER::hash_t *hashes);
+
+	vector<column_function_t> columns;
+
+	explicit SparkHashBindData(vector<column_function_t> columns_p) : columns(std::move(columns_p)) {
+	}
+
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<SparkHashBindData<HASHER>>(columns);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<SparkHashBindData<HASHER>>();
+		return columns == other.columns;
+	}
+};
+
+// Registers spark_hash and spark_xxhash64 (see spark_hash.cpp).
+void RegisterSparkHashFunctions(ExtensionLoader &loader);
+
+} // namespace duckdb
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+class ExtensionLoader;
+
+// ---------------------------------------------------------------------------
+// Plan rewrites for Spark aggregates
+// ---------------------------------------------------------------------------
+// Constant divisors: a Spark DECIMAL division (the DECIMAL `/` or
+// spark_decimal_div) whose operands fold to constants, e.g. `x / (1 + 1)`, has
+// them folded and is bound again, so the divisor gets its precomputed
+// reciprocal, or its exact multiplier when it divides 10^scale_adj (a power of
+// ten then only rescales), exactly as a literal divisor does.
+
+static constexpr const char *SPARK_CONSTANT_DIVISOR_SETTING = "spark_constant_divisor";
+
+// Shared sum + count: within one aggregate, spark_sum(x), spark_avg(x) and
+// count(x) over the same DECIMAL argument are replaced by one
+// spark_sum_count(x), and a projection above the aggregate extracts the
+// individual results. Only plain aggregates qualify (no DISTINCT, FILTER or
+// ORDER BY), and at least one spark_sum or spark_avg must take part.
+
+static constexpr const char *SPARK_SHARED_SUM_COUNT_SETTING = "spark_shared_sum_count";
+
+// Fused sum ratio: in a projection directly above an aggregate,
+// spark_sum(a) / spark_sum(b) (the DECIMAL `/` or spark_decimal_div) becomes
+// one spark_sum_ratio(a, b), and sums no longer read elsewhere are dropped.
+// The same plain-aggregate restriction applies to both sums.
+
+static constexpr const char *SPARK_FUSED_SUM_RATIO_SETTING = "spark_fused_sum_ratio";
+
+// Division comparisons: a =, <>, <, <=, > or >= between a Spark DECIMAL
+// division (the DECIMAL `/` or spark_decimal_div) and a constant becomes
+// spark_decimal_div_{eq,ne,lt,le,gt,ge}(a, b, c), which decides it without
+// computing the quotient (see spark_div_compare.hpp).
+
+static constexpr const char *SPARK_DIV_COMPARISON_SETTING = "spark_div_comparison";
+
+// Registers the rewrites and their settings (see spark_optimizer.cpp).
+void RegisterSparkOptimizerRules(ExtensionLoader &loader);
+
+} // namespace duckdb
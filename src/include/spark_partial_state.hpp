@@ -0,0 +1,332 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "spark_aggregates.hpp"
+
+namespace duckdb {
+
+// ============================================================================
+// spark_sum_state / spark_avg_state and spark_sum_merge / spark_avg_merge:
+// partial DECIMAL aggregates exchanged between workers as BLOBs
+//
+// The *_state aggregates run the usual spark_sum / spark_avg accumulation and
+// emit the raw state instead of the result. The *_merge aggregates add the
+// states back up and run the normal finalize (result type, HALF_UP rounding
+// and overflow handling), so
+//   spark_avg_merge(spark_avg_state(x), p, s) == spark_avg(x)
+// for a DECIMAL(p, s) column x, however the rows were split among workers.
+//
+// A state is a fixed 28-byte little-endian record:
+//   [0]      format version (1)
+//   [1]      kind (1 = sum, 2 = avg)
+//   [2], [3] precision and scale of the aggregated DECIMAL
+//   [4, 12)  row count (avg) or 1 for a non-empty sum; 0 for an empty group
+//   [12, 28) sum of the scaled values as a two's complement 128-bit integer
+// ============================================================================
+
+enum class SparkPartialStateKind : uint8_t { SUM = 1, AVG = 2 };
+
+struct SparkPartialStateBlob {
+	static constexpr uint8_t VERSION = 1;
+	static constexpr idx_t SIZE = 28;
+
+	SparkPartialStateKind kind;
+	uint8_t precision;
+	uint8_t scale;
+	uint64_t count;
+	__int128 sum;
+
+	static void Store64(data_ptr_t dst, uint64_t value) {
+		for (idx_t i = 0; i < 8; i++) {
+			dst[i] = static_cast<data_t>(value >> (8 * i));
+		}
+	}
+
+	static uint64_t Load64(const_data_ptr_t src) {
+		uint64_t value = 0;
+		for (idx_t i = 0; i < 8; i++) {
+			value |= static_cast<uint64_t>(src[i]) << (8 * i);
+		}
+		return value;
+	}
+
+	void Serialize(data_ptr_t dst) const {
+		dst[0] = VERSION;
+		dst[1] = static_cast<data_t>(kind);
+		dst[2] = precision;
+		dst[3] = scale;
+		Store64(dst + 4, count);
+		Store64(dst + 12, static_cast<uint64_t>(sum));
+		Store64(dst + 20, static_cast<uint64_t>(static_cast<unsigned __int128>(sum) >> 64));
+	}
+
+	// Throws unless `input` is a state of `kind` for DECIMAL(precision, scale)
+	static SparkPartialStateBlob Deserialize(const string_t &input, SparkPartialStateKind kind, uint8_t precision,
+	                                         uint8_t scale, const char *function_name) {
+		auto data = const_data_ptr_cast(input.GetData());
+		if (input.GetSize() != SIZE || data[0] != VERSION || data[1] != static_cast<data_t>(kind)) {
+			throw InvalidInputException("%s: input is not a %s result", function_name,
+			                            kind == SparkPartialStateKind::SUM ? "spark_sum_state" : "spark_avg_state");
+		}
+		if (data[2] != precision || data[3] != scale) {
+			throw InvalidInputException("%s: state was produced for DECIMAL(%d,%d), expected DECIMAL(%d,%d)",
+			                            function_name, static_cast<int32_t>(data[2]), static_cast<int32_t>(data[3]),
+			                            static_cast<int32_t>(precision), static_cast<int32_t>(scale));
+		}
+		SparkPartialStateBlob blob;
+		blob.kind = kind;
+		blob.precision = precision;
+		blob.scale = scale;
+		blob.count = Load64(data + 4);
+		blob.sum = static_cast<__int128>((static_cast<unsigned __int128>(Load64(data + 20)) << 64) | Load64(data + 12));
+		return blob;
+	}
+};
+
+// Bind data for the state and merge aggregates: the aggregated DECIMAL type
+// in addition to the spark_sum / spark_avg finalize parameters.
+struct SparkPartialStateBindData : public SparkAggBindData {
+	uint8_t input_precision;
+
+	SparkPartialStateBindData(uint8_t input_precision_p, uint8_t input_scale_p, const SparkDecimalResult &result_p,
+	                          bool ansi_p)
+	    : SparkAggBindData(input_scale_p, result_p, ansi_p), input_precision(input_precision_p) {
+	}
+
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<SparkPartialStateBindData>(input_precision, input_scale,
+		                                            SparkDecimalResult {result_precision, result_scale}, ansi);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<SparkPartialStateBindData>();
+		return SparkAggBindData::Equals(other_p) && input_precision == other.input_precision;
+	}
+};
+
+struct SparkSumPartialState {
+	static constexpr SparkPartialStateKind KIND = SparkPartialStateKind::SUM;
+	static constexpr const char *STATE_NAME = "spark_sum_state";
+	static constexpr const char *MERGE_NAME = "spark_sum_merge";
+	template <typename RESULT_TYPE>
+	using Operation = SparkSumDecimalOperation<RESULT_TYPE>;
+	template <typename INPUT_TYPE>
+	using StateFor = SparkSumDecimalStateFor<INPUT_TYPE>;
+	using MergeState = SparkSumDecimalState;
+
+	static SparkDecimalResult ResultType(uint8_t p, uint8_t s) {
+		return ComputeSumType(p, s);
+	}
+	template <class STATE>
+	static uint64_t Count(const STATE &state) {
+		return state.isset ? 1 : 0;
+	}
+	template <class STATE>
+	static __int128 Sum(const STATE &state) {
+		return state.Value();
+	}
+};
+
+struct SparkAvgPartialState {
+	static constexpr SparkPartialStateKind KIND = SparkPartialStateKind::AVG;
+	static constexpr const char *STATE_NAME = "spark_avg_state";
+	static constexpr const char *MERGE_NAME = "spark_avg_merge";
+	template <typename RESULT_TYPE>
+	using Operation = SparkAvgDecimalOperation<RESULT_TYPE>;
+	template <typename INPUT_TYPE>
+	using StateFor = SparkAvgDecimalStateFor<INPUT_TYPE>;
+	using MergeState = SparkAvgDecimalState;
+
+	static SparkDecimalResult ResultType(uint8_t p, uint8_t s) {
+		return ComputeAvgType(p, s);
+	}
+	template <class STATE>
+	static uint64_t Count(const STATE &state) {
+		return state.count;
+	}
+	template <class STATE>
+	static __int128 Sum(const STATE &state) {
+		return state.Sum();
+	}
+};
+
+// ----------------------------------------------------------------------------
+// *_state: accumulate as spark_sum / spark_avg, finalize into a BLOB
+// ----------------------------------------------------------------------------
+
+template <class PARTIAL>
+struct SparkPartialStateExportOperation : public PARTIAL::template Operation<hugeint_t> {
+	template <class T, class STATE>
+	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
+		auto &bind_data = finalize_data.input.bind_data->Cast<SparkPartialStateBindData>();
+		SparkPartialStateBlob blob;
+		blob.kind = PARTIAL::KIND;
+		blob.precision = bind_data.input_precision;
+		blob.scale = bind_data.input_scale;
+		blob.count = PARTIAL::Count(state);
+		blob.sum = blob.count > 0 ? PARTIAL::Sum(state) : 0;
+		target = StringVector::EmptyString(finalize_data.result, SparkPartialStateBlob::SIZE);
+		blob.Serialize(data_ptr_cast(target.GetDataWriteable()));
+		target.Finalize();
+	}
+};
+
+template <class PARTIAL, typename INPUT_TYPE, typename STATE = typename PARTIAL::template StateFor<INPUT_TYPE>::type>
+static AggregateFunction GetSparkPartialStateExportFunction() {
+	using OP = SparkPartialStateExportOperation<PARTIAL>;
+	auto function = AggregateFunction::UnaryAggregate<STATE, INPUT_TYPE, string_t, OP>(LogicalType::DECIMAL(38, 0),
+	                                                                                 LogicalType::BLOB);
+	function.update = SparkDecimalScatterUpdate<STATE, INPUT_TYPE, OP>;
+	function.simple_update = SparkDecimalBlockSimpleUpdate<STATE, INPUT_TYPE>;
+	return function;
+}
+
+template <class PARTIAL>
+static AggregateFunction GetSparkPartialStateExportFunction(PhysicalType input_type) {
+	switch (input_type) {
+	case PhysicalType::INT16:
+		return GetSparkPartialStateExportFunction<PARTIAL, int16_t>();
+	case PhysicalType::INT32:
+		return GetSparkPartialStateExportFunction<PARTIAL, int32_t>();
+	case PhysicalType::INT64:
+		return GetSparkPartialStateExportFunction<PARTIAL, int64_t>();
+	case PhysicalType::INT128:
+		return GetSparkPartialStateExportFunction<PARTIAL, hugeint_t>();
+	default:
+		throw InternalException("Unexpected physical type for %s DECIMAL input", PARTIAL::STATE_NAME);
+	}
+}
+
+template <class PARTIAL>
+static unique_ptr<FunctionData> BindSparkPartialStateExport(ClientContext &context, AggregateFunction &function,
+                                                            vector<unique_ptr<Expression>> &arguments) {
+	auto &type = arguments[0]->return_type;
+	if (type.id() != LogicalTypeId::DECIMAL) {
+		throw InvalidInputException("%s requires DECIMAL argument", PARTIAL::STATE_NAME);
+	}
+	uint8_t p = DecimalType::GetWidth(type);
+	uint8_t s = DecimalType::GetScale(type);
+
+	SetSparkAggregateImplementation(function, GetSparkPartialStateExportFunction<PARTIAL>(type.InternalType()));
+	function.arguments[0] = type;
+	return make_uniq<SparkPartialStateBindData>(p, s, PARTIAL::ResultType(p, s), SparkAnsiEnabled(context));
+}
+
+// ----------------------------------------------------------------------------
+// *_merge(state, precision, scale): add up states, finalize as spark_sum / spark_avg
+//
+// States are merged into the hugeint_t state, which holds any 128-bit sum.
+// ----------------------------------------------------------------------------
+
+template <class PARTIAL, typename RESULT_TYPE>
+struct SparkPartialStateMergeOperation : public PARTIAL::template Operation<RESULT_TYPE> {
+	template <class STATE>
+	static void AddState(STATE &state, const string_t &input, AggregateInputData &aggr_input_data) {
+		auto &bind_data = aggr_input_data.bind_data->Cast<SparkPartialStateBindData>();
+		auto blob = SparkPartialStateBlob::Deserialize(input, PARTIAL::KIND, bind_data.input_precision,
+		                                               bind_data.input_scale, PARTIAL::MERGE_NAME);
+		if (blob.count > 0) {
+			state.AddBlock(blob.sum, blob.count);
+		}
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &unary_input) {
+		AddState(state, input, unary_input.input);
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &unary_input,
+	                              idx_t count) {
+		// Each addition is overflow-checked, so the copies are added one by one
+		for (idx_t i = 0; i < count; i++) {
+			AddState(state, input, unary_input.input);
+		}
+	}
+};
+
+template <class PARTIAL, typename RESULT_TYPE>
+static AggregateFunction GetSparkPartialStateMergeFunction() {
+	return AggregateFunction::UnaryAggregate<typename PARTIAL::MergeState, string_t, RESULT_TYPE,
+	                                         SparkPartialStateMergeOperation<PARTIAL, RESULT_TYPE>>(
+	    LogicalType::BLOB, LogicalType::DECIMAL(38, 0));
+}
+
+template <class PARTIAL>
+static AggregateFunction GetSparkPartialStateMergeFunction(PhysicalType result_type) {
+	switch (result_type) {
+	case PhysicalType::INT16:
+		return GetSparkPartialStateMergeFunction<PARTIAL, int16_t>();
+	case PhysicalType::INT32:
+		return GetSparkPartialStateMergeFunction<PARTIAL, int32_t>();
+	case PhysicalType::INT64:
+		return GetSparkPartialStateMergeFunction<PARTIAL, int64_t>();
+	case PhysicalType::INT128:
+		return GetSparkPartialStateMergeFunction<PARTIAL, hugeint_t>();
+	default:
+		throw InternalException("Unexpected physical type for %s DECIMAL result", PARTIAL::MERGE_NAME);
+	}
+}
+
+// Constant INTEGER argument of a merge aggregate (precision or scale)
+template <class PARTIAL>
+static int64_t GetSparkPartialStateTypeArgument(ClientContext &context, Expression &expr, const char *what) {
+	if (!expr.IsFoldable()) {
+		throw BinderException("%s: %s must be a constant", PARTIAL::MERGE_NAME, what);
+	}
+	auto value = ExpressionExecutor::EvaluateScalar(context, expr);
+	if (value.IsNull()) {
+		throw BinderException("%s: %s cannot be NULL", PARTIAL::MERGE_NAME, what);
+	}
+	return value.GetValue<int64_t>();
+}
+
+template <class PARTIAL>
+static unique_ptr<FunctionData> BindSparkPartialStateMerge(ClientContext &context, AggregateFunction &function,
+                                                           vector<unique_ptr<Expression>> &arguments) {
+	auto precision = GetSparkPartialStateTypeArgument<PARTIAL>(context, *arguments[1], "precision");
+	auto scale = GetSparkPartialStateTypeArgument<PARTIAL>(context, *arguments[2], "scale");
+	if (precision < 1 || precision > SPARK_MAX_PRECISION || scale < 0 || scale > precision) {
+		throw BinderException("%s: DECIMAL(%d,%d) is not a valid DECIMAL type", PARTIAL::MERGE_NAME, precision,
+		                      scale);
+	}
+	Function::EraseArgument(function, arguments, 2);
+	Function::EraseArgument(function, arguments, 1);
+
+	auto p = static_cast<uint8_t>(precision);
+	auto s = static_cast<uint8_t>(scale);
+	auto result = PARTIAL::ResultType(p, s);
+	auto result_type = LogicalType::DECIMAL(result.precision, result.scale);
+	SetSparkAggregateImplementation(function, GetSparkPartialStateMergeFunction<PARTIAL>(result_type.InternalType()));
+	function.return_type = result_type;
+	return make_uniq<SparkPartialStateBindData>(p, s, result, SparkAnsiEnabled(context));
+}
+
+// ----------------------------------------------------------------------------
+// Factory functions
+// ----------------------------------------------------------------------------
+
+template <class PARTIAL>
+inline AggregateFunctionSet CreateSparkPartialStateFunctionSet() {
+	AggregateFunctionSet set(PARTIAL::STATE_NAME);
+	// Initial template uses hugeint_t; bind function swaps to the native input width
+	auto decimal_func = GetSparkPartialStateExportFunction<PARTIAL, hugeint_t>();
+	decimal_func.bind = BindSparkPartialStateExport<PARTIAL>;
+	decimal_func.order_dependent = AggregateOrderDependent::NOT_ORDER_DEPENDENT;
+	set.AddFunction(decimal_func);
+	return set;
+}
+
+template <class PARTIAL>
+inline AggregateFunctionSet CreateSparkPartialMergeFunctionSet() {
+	AggregateFunctionSet set(PARTIAL::MERGE_NAME);
+	auto merge_func = GetSparkPartialStateMergeFunction<PARTIAL, hugeint_t>();
+	merge_func.arguments = {LogicalType::BLOB, LogicalType::INTEGER, LogicalType::INTEGER};
+	merge_func.bind = BindSparkPartialStateMerge<PARTIAL>;
+	merge_func.order_dependent = AggregateOrderDependent::NOT_ORDER_DEPENDENT;
+	set.AddFunction(merge_func);
+	return set;
+}
+
+} // namespace duckdb
@@ -1,12 +1,13 @@
 #pragma once
 
 #include "duckdb.hpp"
+#include "decimal_division.hpp"
 #include <algorithm>
 #include <cstdint>
 
 namespace duckdb {
 
-// Spark 4.1 decimal division precision constants
+// Spark 4.1 decimal precision constants
 static constexpr uint8_t SPARK_MAX_PRECISION = 38;
 static constexpr uint8_t SPARK_MIN_ADJUSTED_SCALE = 6;
 
@@ -15,33 +16,58 @@ struct SparkDecimalResult {
 	uint8_t scale;
 };
 
+// Spark's adjustPrecisionScale (spark.sql.decimalOperations.allowPrecisionLoss
+// = true): when the precision exceeds 38, keep the integer digits and give up
+// fractional digits, but keep at least min(scale, 6) of them.
+//   int_digits     = precision - scale
+//   min_scale      = min(scale, 6)
+//   adjusted_scale = max(38 - int_digits, min_scale)
+//   result         = DECIMAL(38, adjusted_scale)
+inline SparkDecimalResult AdjustPrecisionScale(uint32_t precision, uint32_t scale) {
+	if (precision <= SPARK_MAX_PRECISION) {
+		return {static_cast<uint8_t>(precision), static_cast<uint8_t>(scale)};
+	}
+	uint32_t int_digits = precision - scale;
+	uint32_t min_scale = std::min(scale, static_cast<uint32_t>(SPARK_MIN_ADJUSTED_SCALE));
+	uint32_t adjusted_scale = min_scale;
+	if (SPARK_MAX_PRECISION > int_digits) {
+		adjusted_scale = std::max(static_cast<uint32_t>(SPARK_MAX_PRECISION) - int_digits, min_scale);
+	}
+	return {SPARK_MAX_PRECISION, static_cast<uint8_t>(adjusted_scale)};
+}
+
 // Compute result type for DECIMAL division per Spark 4.1 rules.
 //
 // Formula:
 //   result_scale     = max(6, s1 + p2 + 1)
 //   result_precision = (p1 - s1) + s2 + result_scale
-//
-// When result_precision > 38, apply adjustPrecisionScale:
-//   int_digits     = result_precision - result_scale
-//   min_scale      = min(result_scale, 6)
-//   adjusted_scale = max(38 - int_digits, min_scale)
-//   result         = DECIMAL(38, adjusted_scale)
+// followed by AdjustPrecisionScale.
 inline SparkDecimalResult ComputeDivisionType(uint8_t p1, uint8_t s1, uint8_t p2, uint8_t s2) {
-	uint8_t result_scale = std::max(static_cast<uint8_t>(6), static_cast<uint8_t>(s1 + p2 + 1));
-	uint8_t result_precision = (p1 - s1) + s2 + result_scale;
-
-	if (result_precision > SPARK_MAX_PRECISION) {
-		uint8_t int_digits = result_precision - result_scale;
-		uint8_t min_scale = std::min(result_scale, SPARK_MIN_ADJUSTED_SCALE);
-		if (SPARK_MAX_PRECISION > int_digits) {
-			result_scale = std::max(static_cast<uint8_t>(SPARK_MAX_PRECISION - int_digits), min_scale);
-		} else {
-			result_scale = min_scale;
-		}
-		result_precision = SPARK_MAX_PRECISION;
-	}
+	uint32_t result_scale = std::max(6u, static_cast<uint32_t>(s1) + p2 + 1);
+	uint32_t result_precision = static_cast<uint32_t>(p1 - s1) + s2 + result_scale;
+	return AdjustPrecisionScale(result_precision, result_scale);
+}
 
-	return {result_precision, result_scale};
+// Compute result type for DECIMAL multiplication per Spark 4.1 rules.
+//
+// Formula:
+//   result_scale     = s1 + s2
+//   result_precision = p1 + p2 + 1
+// followed by AdjustPrecisionScale.
+inline SparkDecimalResult ComputeMultiplyType(uint8_t p1, uint8_t s1, uint8_t p2, uint8_t s2) {
+	return AdjustPrecisionScale(static_cast<uint32_t>(p1) + p2 + 1, static_cast<uint32_t>(s1) + s2);
+}
+
+// Compute result type for DECIMAL addition and subtraction per Spark 4.1 rules.
+//
+// Formula:
+//   result_scale     = max(s1, s2)
+//   result_precision = max(p1 - s1, p2 - s2) + result_scale + 1
+// followed by AdjustPrecisionScale.
+inline SparkDecimalResult ComputeAddSubtractType(uint8_t p1, uint8_t s1, uint8_t p2, uint8_t s2) {
+	uint32_t result_scale = std::max(s1, s2);
+	uint32_t int_digits = static_cast<uint32_t>(std::max(p1 - s1, p2 - s2));
+	return AdjustPrecisionScale(int_digits + result_scale + 1, result_scale);
 }
 
 // Spark: SUM(DECIMAL(p,s)) -> DECIMAL(min(p+10, 38), s)
@@ -58,20 +84,77 @@ inline SparkDecimalResult ComputeAvgType(uint8_t p, uint8_t s) {
 	return {result_precision, result_scale};
 }
 
+// Compute result type for DECIMAL remainder and pmod per Spark 4.1 rules.
+//
+// Formula:
+//   result_scale     = max(s1, s2)
+//   result_precision = min(p1 - s1, p2 - s2) + result_scale
+// followed by AdjustPrecisionScale (never needed: the precision is at most 38).
+inline SparkDecimalResult ComputeRemainderType(uint8_t p1, uint8_t s1, uint8_t p2, uint8_t s2) {
+	uint32_t result_scale = std::max(s1, s2);
+	uint32_t int_digits = static_cast<uint32_t>(std::min(p1 - s1, p2 - s2));
+	return AdjustPrecisionScale(int_digits + result_scale, result_scale);
+}
+
+// Spark: ROUND/BROUND/CEIL/FLOOR(DECIMAL(p,s), n) (RoundBase). One extra
+// integral digit absorbs the carry (ceil(9.9) = 10):
+//   n >= 0: DECIMAL(min(p - s + 1 + min(s, n), 38), min(s, n))
+//   n <  0: DECIMAL(min(max(p - s + 1, 1 - n), 38), 0)
+inline SparkDecimalResult ComputeRoundType(uint8_t p, uint8_t s, int64_t n) {
+	int64_t integral_digits = static_cast<int64_t>(p) - s + 1;
+	if (n < 0) {
+		int64_t precision = std::max(integral_digits, 1 - n);
+		return {static_cast<uint8_t>(std::min<int64_t>(precision, SPARK_MAX_PRECISION)), 0};
+	}
+	int64_t scale = std::min<int64_t>(s, n);
+	return {static_cast<uint8_t>(std::min<int64_t>(integral_digits + scale, SPARK_MAX_PRECISION)),
+	        static_cast<uint8_t>(scale)};
+}
+
 // Bind data storing precomputed division parameters.
 struct SparkDivBindData : public FunctionData {
 	uint32_t scale_adj; // result_scale - s1 + s2
+	// Set when the divisor folds to a non-zero constant at bind time; the
+	// reciprocal is then computed once per query instead of once per vector.
+	bool has_constant_divisor;
+	SparkConstantDivisor divisor;
+	// Some dividend may exceed 128 bits once scaled (p1 + scale_adj > 38 and not
+	// ruled out by statistics); only then are div_wide_rows counted.
+	bool may_overflow_128;
+	// Some quotient may exceed the result precision (the result type was capped
+	// at 38 digits and statistics do not rule it out): the result vector is range
+	// checked, and overflowing rows are NULL, or an error when ansi is set.
+	bool check_range;
+	bool ansi;
 
-	explicit SparkDivBindData(uint32_t scale_adj_p) : scale_adj(scale_adj_p) {
+	explicit SparkDivBindData(uint32_t scale_adj_p)
+	    : scale_adj(scale_adj_p), has_constant_divisor(false), may_overflow_128(false), check_range(false),
+	      ansi(false) {
+	}
+
+	SparkDivBindData(uint32_t scale_adj_p, const SparkConstantDivisor &divisor_p)
+	    : scale_adj(scale_adj_p), has_constant_divisor(true), divisor(divisor_p), may_overflow_128(false),
+	      check_range(false), ansi(false) {
 	}
 
 	unique_ptr<FunctionData> Copy() const override {
-		return make_uniq<SparkDivBindData>(scale_adj);
+		auto copy = make_uniq<SparkDivBindData>(scale_adj);
+		copy->has_constant_divisor = has_constant_divisor;
+		copy->divisor = divisor;
+		copy->may_overflow_128 = may_overflow_128;
+		copy->check_range = check_range;
+		copy->ansi = ansi;
+		return std::move(copy);
 	}
 
 	bool Equals(const FunctionData &other_p) const override {
 		auto &other = other_p.Cast<SparkDivBindData>();
-		return scale_adj == other.scale_adj;
+		if (scale_adj != other.scale_adj || has_constant_divisor != other.has_constant_divisor ||
+		    may_overflow_128 != other.may_overflow_128 || check_range != other.check_range || ansi != other.ansi) {
+			return false;
+		}
+		return !has_constant_divisor ||
+		       (divisor.abs_b == other.divisor.abs_b && divisor.negative == other.divisor.negative);
 	}
 };
 
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "wide_integer.hpp"
+#include "spark_precision.hpp"
+
+namespace duckdb {
+
+class ExtensionLoader;
+
+// ---------------------------------------------------------------------------
+// Spark ROUND / BROUND / CEIL / FLOOR on DECIMAL(p, s) with a constant scale n
+// ---------------------------------------------------------------------------
+// The scaled input v is divided by 10^drop (drop = s - n, the digits removed),
+// the quotient adjusted by the rounding mode, and, for n < 0, multiplied back
+// by 10^-n since the result scale is 0. Result types follow ComputeRoundType; a
+// result that does not fit is NULL (or an error in ANSI mode).
+//
+// T is the compute type: int64_t when input and result both fit 18 digits,
+// __int128 otherwise.
+
+enum class SparkRoundMode : uint8_t { HALF_UP, HALF_EVEN, CEILING, FLOOR };
+
+template <typename T>
+struct SparkRoundParams {
+	T divisor;     // 10^drop; 0 when more digits are dropped than any input has (the quotient is 0)
+	T multiplier;  // 10^-n for n < 0, otherwise 1; 0 when it alone exceeds the result precision
+	T limit;       // 10^result_precision
+	bool identity; // drop == 0 and multiplier == 1: the value only changes width
+};
+
+// max_digits: digits of the largest input value of T (18 for int64_t, 38 for __int128)
+template <typename T>
+inline SparkRoundParams<T> MakeSparkRoundParams(uint8_t input_scale, int64_t n, const SparkDecimalResult &result,
+                                                uint32_t max_digits) {
+	SparkRoundParams<T> params;
+	int64_t result_scale = n < 0 ? 0 : result.scale;
+	int64_t drop = static_cast<int64_t>(input_scale) - (n < 0 ? n : result_scale);
+	params.divisor =
+	    drop > static_cast<int64_t>(max_digits) ? T(0) : static_cast<T>(Pow10_128(static_cast<uint32_t>(drop)));
+	params.multiplier = T(1);
+	if (n < 0) {
+		params.multiplier = -n < result.precision ? static_cast<T>(Pow10_128(static_cast<uint32_t>(-n))) : T(0);
+	}
+	params.limit = static_cast<T>(Pow10_128(result.precision));
+	params.identity = drop == 0 && params.multiplier == T(1);
+	return params;
+}
+
+// Round the scaled value v. Returns false when the result does not fit the
+// result precision.
+template <typename T, SparkRoundMode MODE>
+inline bool SparkRoundScaled(T v, const SparkRoundParams<T> &params, T &result) {
+	if (params.identity) {
+		result = v;
+		return v < params.limit && v > -params.limit;
+	}
+	T quotient = 0;
+	T remainder = v;
+	if (params.divisor != 0) {
+		quotient = v / params.divisor;
+		remainder = v % params.divisor;
+	}
+	T abs_remainder = remainder < 0 ? -remainder : remainder;
+	bool away = false; // step the quotient away from zero
+	switch (MODE) {
+	case SparkRoundMode::HALF_UP:
+		// 2 * |r| >= 10^drop; never when every digit is dropped (|v| < 10^max_digits)
+		away = params.divisor != 0 && abs_remainder >= params.divisor - abs_remainder;
+		break;
+	case SparkRoundMode::HALF_EVEN:
+		if (params.divisor != 0) {
+			T twice_excess = abs_remainder - (params.divisor - abs_remainder); // 2 * |r| - 10^drop
+			away = twice_excess > 0 || (twice_excess == 0 && (quotient & 1) != 0);
+		}
+		break;
+	case SparkRoundMode::CEILING:
+		away = remainder > 0;
+		break;
+	case SparkRoundMode::FLOOR:
+		away = remainder < 0;
+		break;
+	}
+	if (away) {
+		quotient += v < 0 ? T(-1) : T(1);
+	}
+
+	if (params.multiplier == 0) {
+		result = 0;
+		return quotient == 0;
+	}
+	if (__builtin_mul_overflow(quotient, params.multiplier, &result)) {
+		return false;
+	}
+	return result < params.limit && result > -params.limit;
+}
+
+// Bind data for spark_round / spark_bround / spark_ceil / spark_floor.
+struct SparkRoundBindData : public FunctionData {
+	SparkRoundParams<int64_t> params64;
+	SparkRoundParams<__int128> params128;
+	bool ansi; // overflow raises an error instead of returning NULL
+
+	SparkRoundBindData(const SparkRoundParams<int64_t> &params64_p, const SparkRoundParams<__int128> &params128_p,
+	                   bool ansi_p)
+	    : params64(params64_p), params128(params128_p), ansi(ansi_p) {
+	}
+
+	const SparkRoundParams<int64_t> &Params(int64_t) const {
+		return params64;
+	}
+	const SparkRoundParams<__int128> &Params(__int128) const {
+		return params128;
+	}
+
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<SparkRoundBindData>(params64, params128, ansi);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<SparkRoundBindData>();
+		return params128.divisor == other.params128.divisor && params128.multiplier == other.params128.multiplier &&
+		       params128.limit == other.params128.limit && ansi == other.ansi;
+	}
+};
+
+// Registers spark_round, spark_bround, spark_ceil and spark_floor (see spark_round.cpp).
+void RegisterSparkRoundFunctions(ExtensionLoader &loader);
+
+} // namespace duckdb
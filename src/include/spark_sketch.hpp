@@ -0,0 +1,287 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+#include <cmath>
+
+namespace duckdb {
+
+// ============================================================================
+// Sketches behind spark_approx_count_distinct and spark_percentile_approx
+//
+// Both follow Spark's algorithms and parameters (rsd, accuracy) and merge in
+// time linear in the sketch size (partial aggregates from parallel threads).
+// spark_percentile_approx answers like Spark for the same values in the same
+// order; spark_approx_count_distinct does so outside the bias-correction band
+// described below.
+// Values are DECIMAL scaled integers; nothing is converted to DOUBLE.
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// HyperLogLog++ (HyperLogLogPlusPlusHelper)
+//
+// 2^p one-byte registers, p = ceil(2 * log2(1.106 / rsd)). A 64-bit hash
+// selects the register with its top p bits; the register keeps the largest
+// position of the first set bit in the remaining bits. The estimate is
+// linear counting while registers are still empty and the count is small
+// (Spark's thresholds, or the classic 2.5 * 2^p bound), and the raw HLL
+// estimate otherwise. Spark's empirical bias-correction tables are not
+// included: in the band between those two bounds and 5 * 2^p, the raw
+// estimate is used as is, where Spark subtracts an interpolated bias.
+// ----------------------------------------------------------------------------
+
+struct SparkHyperLogLog {
+	static constexpr uint8_t MIN_PRECISION = 4;
+	static constexpr uint8_t MAX_PRECISION = 18;
+	static constexpr double DEFAULT_RSD = 0.05;
+
+	// Register-index bits for a relative standard deviation; 0 when rsd is not positive
+	static inline int32_t Precision(double rsd) {
+		if (!(rsd > 0)) {
+			return 0;
+		}
+		return static_cast<int32_t>(std::ceil(2.0 * std::log(1.106 / rsd) / std::log(2.0)));
+	}
+
+	static inline idx_t RegisterCount(uint8_t p) {
+		return idx_t(1) << p;
+	}
+
+	static inline void Update(uint8_t *registers, uint8_t p, uint64_t hash) {
+		auto idx = hash >> (64 - p);
+		// The padding bit bounds the run of zeros, so w is never 0
+		uint64_t w = (hash << p) | (uint64_t(1) << (p - 1));
+		auto pw = static_cast<uint8_t>(__builtin_clzll(w) + 1);
+		if (pw > registers[idx]) {
+			registers[idx] = pw;
+		}
+	}
+
+	static inline void Merge(uint8_t *target, const uint8_t *source, uint8_t p) {
+		auto m = RegisterCount(p);
+		for (idx_t i = 0; i < m; i++) {
+			target[i] = source[i] > target[i] ? source[i] : target[i];
+		}
+	}
+
+	static int64_t Estimate(const uint8_t *registers, uint8_t p) {
+		// Linear counting thresholds of HLL++ for p = 4 .. 18
+		static const double THRESHOLDS[] = {10,   20,    40,    80,    220,   400,    900,   1800,
+		                                    3100, 6500, 11500, 20000, 50000, 120000, 350000};
+		auto m = static_cast<double>(RegisterCount(p));
+		double alpha;
+		switch (p) {
+		case 4:
+			alpha = 0.673;
+			break;
+		case 5:
+			alpha = 0.697;
+			break;
+		case 6:
+			alpha = 0.709;
+			break;
+		default:
+			alpha = 0.7213 / (1.0 + 1.079 / m);
+			break;
+		}
+
+		double z_inverse = 0;
+		idx_t zeros = 0;
+		for (idx_t i = 0; i < RegisterCount(p); i++) {
+			z_inverse += std::ldexp(1.0, -static_cast<int>(registers[i]));
+			zeros += registers[i] == 0;
+		}
+		double estimate = alpha * m * m / z_inverse;
+		if (zeros > 0) {
+			double linear = m * std::log(m / static_cast<double>(zeros));
+			if (linear <= THRESHOLDS[p - MIN_PRECISION] || estimate <= 2.5 * m) {
+				estimate = linear;
+			}
+		}
+		return static_cast<int64_t>(std::llround(estimate));
+	}
+};
+
+// ----------------------------------------------------------------------------
+// Greenwald-Khanna quantile summary (QuantileSummaries)
+//
+// Values are buffered and inserted in sorted batches; the sample list is
+// compressed once it reaches COMPRESS_THRESHOLD entries, and always before a
+// merge or a query. Every sample carries g (the rank gap to its predecessor)
+// and delta (the rank uncertainty), kept within 2 * relative_error * count.
+// A query returns one of the inserted values: the first or the last one for
+// a quantile within relative_error of 0 or 1, otherwise the first sample
+// whose rank range covers ceil(quantile * count).
+// ----------------------------------------------------------------------------
+
+template <typename T>
+class SparkQuantileSummary {
+public:
+	static constexpr idx_t COMPRESS_THRESHOLD = 10000;
+	static constexpr idx_t HEAD_SIZE = 50000;
+
+	struct Sample {
+		T value;
+		int64_t g;
+		int64_t delta;
+	};
+
+	explicit SparkQuantileSummary(double relative_error_p) : relative_error(relative_error_p) {
+	}
+
+	int64_t Count() const {
+		return count + static_cast<int64_t>(head.size());
+	}
+
+	void Insert(T value) {
+		head.push_back(value);
+		compressed = false;
+		if (head.size() >= HEAD_SIZE) {
+			InsertHead();
+			if (sampled.size() >= COMPRESS_THRESHOLD) {
+				Compress();
+			}
+		}
+	}
+
+	void Compress() {
+		if (compressed) {
+			return;
+		}
+		InsertHead();
+		sampled = CompressSamples(sampled, 2 * relative_error * static_cast<double>(count));
+		compressed = true;
+	}
+
+	// Merges `other` into this summary; both are compressed first
+	void Merge(SparkQuantileSummary &other) {
+		Compress();
+		other.Compress();
+		if (other.count == 0) {
+			return;
+		}
+		if (count == 0) {
+			sampled = other.sampled;
+			count = other.count;
+			relative_error = other.relative_error;
+			return;
+		}
+		// A sample that lands between samples of the other side inherits the
+		// other side's rank uncertainty
+		auto self_extra = static_cast<int64_t>(std::floor(2 * other.relative_error * static_cast<double>(other.count)));
+		auto other_extra = static_cast<int64_t>(std::floor(2 * relative_error * static_cast<double>(count)));
+		vector<Sample> merged;
+		merged.reserve(sampled.size() + other.sampled.size());
+		idx_t self_idx = 0;
+		idx_t other_idx = 0;
+		while (self_idx < sampled.size() && other_idx < other.sampled.size()) {
+			if (sampled[self_idx].value < other.sampled[other_idx].value) {
+				merged.push_back(sampled[self_idx++]);
+				merged.back().delta += other_idx > 0 ? self_extra : 0;
+			} else {
+				merged.push_back(other.sampled[other_idx++]);
+				merged.back().delta += self_idx > 0 ? other_extra : 0;
+			}
+		}
+		merged.insert(merged.end(), sampled.begin() + static_cast<int64_t>(self_idx), sampled.end());
+		merged.insert(merged.end(), other.sampled.begin() + static_cast<int64_t>(other_idx), other.sampled.end());
+
+		relative_error = MaxValue(relative_error, other.relative_error);
+		count += other.count;
+		sampled = CompressSamples(merged, 2 * relative_error * static_cast<double>(count));
+	}
+
+	// Requires a compressed, non-empty summary
+	T Query(double quantile) const {
+		D_ASSERT(compressed && !sampled.empty());
+		if (quantile <= relative_error) {
+			return sampled.front().value;
+		}
+		if (quantile >= 1 - relative_error) {
+			return sampled.back().value;
+		}
+		auto rank = static_cast<int64_t>(std::ceil(quantile * static_cast<double>(count)));
+		int64_t target_error = 0;
+		for (auto &sample : sampled) {
+			target_error = MaxValue(target_error, sample.g + sample.delta);
+		}
+		target_error /= 2;
+
+		int64_t min_rank = 0;
+		for (idx_t i = 0; i + 1 < sampled.size(); i++) {
+			min_rank += sampled[i].g;
+			int64_t max_rank = min_rank + sampled[i].delta;
+			if (max_rank - target_error <= rank && rank <= min_rank + target_error) {
+				return sampled[i].value;
+			}
+		}
+		return sampled.back().value;
+	}
+
+private:
+	// Sorts the buffered values into the sample list
+	void InsertHead() {
+		if (head.empty()) {
+			return;
+		}
+		std::sort(head.begin(), head.end());
+		vector<Sample> samples;
+		samples.reserve(sampled.size() + head.size());
+		idx_t sample_idx = 0;
+		for (idx_t i = 0; i < head.size(); i++) {
+			auto value = head[i];
+			while (sample_idx < sampled.size() && sampled[sample_idx].value <= value) {
+				samples.push_back(sampled[sample_idx++]);
+			}
+			count++;
+			// The new minimum and the new maximum are exact
+			int64_t delta = 0;
+			if (!samples.empty() && !(sample_idx == sampled.size() && i == head.size() - 1)) {
+				delta = static_cast<int64_t>(std::floor(2 * relative_error * static_cast<double>(count)));
+			}
+			samples.push_back(Sample {value, 1, delta});
+		}
+		samples.insert(samples.end(), sampled.begin() + static_cast<int64_t>(sample_idx), sampled.end());
+		sampled = std::move(samples);
+		head.clear();
+	}
+
+	// Folds each sample into its successor while the combined rank range stays
+	// below the threshold. The minimum and the maximum are always kept.
+	static vector<Sample> CompressSamples(const vector<Sample> &samples, double merge_threshold) {
+		vector<Sample> result;
+		if (samples.empty()) {
+			return result;
+		}
+		// Built back to front
+		Sample head_sample = samples.back();
+		for (idx_t i = samples.size() - 1; i-- > 1;) {
+			auto &sample = samples[i];
+			if (static_cast<double>(sample.g + head_sample.g + head_sample.delta) < merge_threshold) {
+				head_sample.g += sample.g;
+			} else {
+				result.push_back(head_sample);
+				head_sample = sample;
+			}
+		}
+		result.push_back(head_sample);
+		if (samples.size() > 1 && samples.front().value <= head_sample.value) {
+			result.push_back(samples.front());
+		}
+		std::reverse(result.begin(), result.end());
+		return result;
+	}
+
+	double relative_error;
+	vector<Sample> sampled;
+	vector<T> head;
+	int64_t count = 0; // values in `sampled`
+	bool compressed = true;
+};
+
+template <typename T>
+constexpr idx_t SparkQuantileSummary<T>::COMPRESS_THRESHOLD;
+template <typename T>
+constexpr idx_t SparkQuantileSummary<T>::HEAD_SIZE;
+
+} // namespace duckdb
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/types/decimal.hpp"
+#include "duckdb/storage/statistics/base_statistics.hpp"
+#include "duckdb/storage/statistics/numeric_stats.hpp"
+#include "wide_integer.hpp"
+#include "decimal_division.hpp"
+
+namespace duckdb {
+
+// ============================================================================
+// Helpers shared by the statistics callbacks of spark_decimal_div and the
+// Spark aggregates. DECIMAL values are handled as __int128 scaled integers.
+// ============================================================================
+
+// Unscaled integer of a DECIMAL Value of any physical width
+inline __int128 DecimalValueToInt128(const Value &value) {
+	switch (value.type().InternalType()) {
+	case PhysicalType::INT16:
+		return value.GetValueUnsafe<int16_t>();
+	case PhysicalType::INT32:
+		return value.GetValueUnsafe<int32_t>();
+	case PhysicalType::INT64:
+		return value.GetValueUnsafe<int64_t>();
+	case PhysicalType::INT128:
+		return HugeintToInt128(value.GetValueUnsafe<hugeint_t>());
+	default:
+		throw InternalException("Unexpected physical type for DECIMAL constant");
+	}
+}
+
+// DECIMAL(width, scale) Value holding the unscaled integer `value`
+inline Value Int128ToDecimalValue(__int128 value, uint8_t width, uint8_t scale) {
+	if (width <= Decimal::MAX_WIDTH_INT64) {
+		return Value::DECIMAL(static_cast<int64_t>(value), width, scale);
+	}
+	return Value::DECIMAL(Int128ToHugeint(value), width, scale);
+}
+
+// Unscaled min/max of DECIMAL column statistics; false when unknown
+inline bool TryGetDecimalStatsBounds(const BaseStatistics &stats, __int128 &min_val, __int128 &max_val) {
+	if (stats.GetType().id() != LogicalTypeId::DECIMAL || !NumericStats::HasMinMax(stats)) {
+		return false;
+	}
+	min_val = DecimalValueToInt128(NumericStats::Min(stats));
+	max_val = DecimalValueToInt128(NumericStats::Max(stats));
+	return true;
+}
+
+inline bool BoundsFitInt64(__int128 min_val, __int128 max_val) {
+	return min_val >= -static_cast<__int128>(NumericLimits<int64_t>::Maximum()) &&
+	       max_val <= static_cast<__int128>(NumericLimits<int64_t>::Maximum());
+}
+
+inline bool FitsDecimalWidth(__int128 value, uint8_t width) {
+	return Abs128(value) < Pow10_128(width);
+}
+
+// Numeric statistics for a DECIMAL result with the given unscaled bounds
+inline unique_ptr<BaseStatistics> MakeDecimalStats(const LogicalType &type, __int128 min_val, __int128 max_val,
+                                                   bool can_have_null) {
+	auto width = DecimalType::GetWidth(type);
+	auto scale = DecimalType::GetScale(type);
+	auto stats = NumericStats::CreateUnknown(type);
+	NumericStats::SetMin(stats, Int128ToDecimalValue(min_val, width, scale));
+	NumericStats::SetMax(stats, Int128ToDecimalValue(max_val, width, scale));
+	stats.Set(can_have_null ? StatsInfo::CAN_HAVE_NULL_AND_VALID_VALUES : StatsInfo::CANNOT_HAVE_NULL_VALUES);
+	return stats.ToUnique();
+}
+
+// SparkDecimalDivide for statistics bounds: a and b may come from different
+// rows, so the quotient is only computed when it provably fits `width` digits.
+inline bool TrySparkDivideBound(__int128 a, __int128 b, const SparkDivScale &scale, uint8_t width,
+                                __int128 &result) {
+	D_ASSERT(b != 0);
+	// With pow10_extra the scaled dividend can exceed 256 bits; the quotient
+	// then saturates, and the width check below rejects it
+	if (scale.pow10_extra == 1) {
+		unsigned __int128 abs_a = Abs128(a);
+		unsigned __int128 abs_b = Abs128(b);
+		uint256_t num = Mul128(abs_a, scale.pow10_val ? scale.pow10_val : 1);
+		uint256_t limit = Mul128(abs_b, Pow10_128(width));
+		if (num.hi > limit.hi || (num.hi == limit.hi && num.lo >= limit.lo)) {
+			return false;
+		}
+	}
+	result = SparkDecimalDivide(a, b, scale.pow10_val, scale.pow10_extra);
+	return FitsDecimalWidth(result, width);
+}
+
+} // namespace duckdb
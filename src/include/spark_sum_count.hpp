@@ -0,0 +1,214 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/storage/statistics/struct_stats.hpp"
+#include "spark_aggregates.hpp"
+
+namespace duckdb {
+
+// ============================================================================
+// spark_sum_count: one shared sum + count state for spark_sum, spark_avg and
+// count over the same DECIMAL argument
+//
+// Accumulates exactly like spark_avg (same states, update and combine) and
+// finalizes into STRUCT(sum, avg, count), where sum and avg have the
+// spark_sum and spark_avg result types and the same overflow handling:
+//   spark_sum_count(x).sum   == spark_sum(x)
+//   spark_sum_count(x).avg   == spark_avg(x)
+//   spark_sum_count(x).count == count(x)
+// The shared-aggregate optimizer rule (spark_optimizer.cpp) rewrites sibling
+// aggregates into it, so a group keeps one state and adds each value once.
+// ============================================================================
+
+static constexpr const char *SPARK_SUM_COUNT_NAME = "spark_sum_count";
+
+struct SparkSumCountBindData : public FunctionData {
+	uint8_t input_scale;
+	SparkDecimalResult sum;
+	SparkDecimalResult avg;
+	bool ansi; // overflow of a result precision raises an error instead of returning NULL
+
+	SparkSumCountBindData(uint8_t input_scale_p, const SparkDecimalResult &sum_p, const SparkDecimalResult &avg_p,
+	                      bool ansi_p)
+	    : input_scale(input_scale_p), sum(sum_p), avg(avg_p), ansi(ansi_p) {
+	}
+
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<SparkSumCountBindData>(input_scale, sum, avg, ansi);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<SparkSumCountBindData>();
+		return input_scale == other.input_scale && sum.precision == other.sum.precision &&
+		       sum.scale == other.sum.scale && avg.precision == other.avg.precision &&
+		       avg.scale == other.avg.scale && ansi == other.ansi;
+	}
+};
+
+static inline LogicalType SparkSumCountResultType(const SparkDecimalResult &sum, const SparkDecimalResult &avg) {
+	child_list_t<LogicalType> children;
+	children.emplace_back("sum", LogicalType::DECIMAL(sum.precision, sum.scale));
+	children.emplace_back("avg", LogicalType::DECIMAL(avg.precision, avg.scale));
+	children.emplace_back("count", LogicalType::BIGINT);
+	return LogicalType::STRUCT(std::move(children));
+}
+
+// Writes one DECIMAL field of the result, with the Spark overflow check
+static inline void SparkSumCountWriteDecimal(Vector &target, idx_t row, __int128 val, const SparkDecimalResult &type,
+                                             bool ansi) {
+	if (__builtin_expect(Abs128(val) >= Pow10_128(type.precision), 0)) {
+		if (ansi) {
+			ThrowSparkDecimalOverflow(LogicalType::DECIMAL(type.precision, type.scale));
+		}
+		FlatVector::SetNull(target, row, true);
+		return;
+	}
+	switch (target.GetType().InternalType()) {
+	case PhysicalType::INT16:
+		WriteAggResult(FlatVector::GetData<int16_t>(target)[row], val);
+		break;
+	case PhysicalType::INT32:
+		WriteAggResult(FlatVector::GetData<int32_t>(target)[row], val);
+		break;
+	case PhysicalType::INT64:
+		WriteAggResult(FlatVector::GetData<int64_t>(target)[row], val);
+		break;
+	case PhysicalType::INT128:
+		WriteAggResult(FlatVector::GetData<hugeint_t>(target)[row], val);
+		break;
+	default:
+		throw InternalException("Unexpected physical type for spark_sum_count DECIMAL result");
+	}
+}
+
+template <class STATE>
+static void SparkSumCountFinalize(Vector &states, AggregateInputData &aggr_input_data, Vector &result, idx_t count,
+                                  idx_t offset) {
+	auto &bind_data = aggr_input_data.bind_data->Cast<SparkSumCountBindData>();
+	auto &fields = StructVector::GetEntries(result);
+	auto &sum_vector = *fields[0];
+	auto &avg_vector = *fields[1];
+	auto count_data = FlatVector::GetData<int64_t>(*fields[2]);
+
+	// As in SparkAvgDecimalOperation::Finalize
+	uint32_t scale_adj = static_cast<uint32_t>(bind_data.avg.scale) - static_cast<uint32_t>(bind_data.input_scale);
+	unsigned __int128 pow10_val = (scale_adj > 0) ? Pow10_128(scale_adj) : 0;
+
+	UnifiedVectorFormat sdata;
+	states.ToUnifiedFormat(count, sdata);
+	auto state_ptrs = UnifiedVectorFormat::GetData<STATE *>(sdata);
+	for (idx_t i = 0; i < count; i++) {
+		auto &state = *state_ptrs[sdata.sel->get_index(i)];
+		idx_t row = i + offset;
+		count_data[row] = static_cast<int64_t>(state.count);
+		if (state.count == 0) {
+			FlatVector::SetNull(sum_vector, row, true);
+			FlatVector::SetNull(avg_vector, row, true);
+			continue;
+		}
+		__int128 sum_val = state.Sum();
+		SparkSumCountWriteDecimal(sum_vector, row, sum_val, bind_data.sum, bind_data.ansi);
+		__int128 avg_val = SparkDecimalDivide(sum_val, static_cast<__int128>(state.count), pow10_val);
+		SparkSumCountWriteDecimal(avg_vector, row, avg_val, bind_data.avg, bind_data.ansi);
+	}
+}
+
+// Helper: create a spark_sum_count AggregateFunction for a specific input physical type
+template <typename INPUT_TYPE, typename STATE = typename SparkAvgDecimalStateFor<INPUT_TYPE>::type>
+static AggregateFunction GetSparkSumCountFunction() {
+	using OP = SparkAvgDecimalOperation<hugeint_t>;
+	auto function = AggregateFunction::UnaryAggregate<STATE, INPUT_TYPE, hugeint_t, OP>(LogicalType::DECIMAL(38, 0),
+	                                                                                   LogicalType::DECIMAL(38, 0));
+	function.update = SparkDecimalScatterUpdate<STATE, INPUT_TYPE, OP>;
+	function.simple_update = SparkDecimalBlockSimpleUpdate<STATE, INPUT_TYPE>;
+	function.finalize = SparkSumCountFinalize<STATE>;
+	return function;
+}
+
+static AggregateFunction GetSparkSumCountFunction(PhysicalType input_type) {
+	switch (input_type) {
+	case PhysicalType::INT16:
+		return GetSparkSumCountFunction<int16_t>();
+	case PhysicalType::INT32:
+		return GetSparkSumCountFunction<int32_t>();
+	case PhysicalType::INT64:
+		return GetSparkSumCountFunction<int64_t>();
+	case PhysicalType::INT128:
+		return GetSparkSumCountFunction<hugeint_t>();
+	default:
+		throw InternalException("Unexpected physical type for spark_sum_count DECIMAL input");
+	}
+}
+
+static unique_ptr<FunctionData> BindSparkSumCount(ClientContext &context, AggregateFunction &function,
+                                                  vector<unique_ptr<Expression>> &arguments) {
+	auto &type = arguments[0]->return_type;
+	if (type.id() != LogicalTypeId::DECIMAL) {
+		throw InvalidInputException("spark_sum_count requires DECIMAL argument");
+	}
+
+	uint8_t p = DecimalType::GetWidth(type);
+	uint8_t s = DecimalType::GetScale(type);
+	auto sum = ComputeSumType(p, s);
+	auto avg = ComputeAvgType(p, s);
+
+	SetSparkAggregateImplementation(function, GetSparkSumCountFunction(type.InternalType()));
+	function.arguments[0] = type;
+	function.return_type = SparkSumCountResultType(sum, avg);
+
+	return make_uniq<SparkSumCountBindData>(s, sum, avg, SparkAnsiEnabled(context));
+}
+
+// Statistics: narrows hugeint_t inputs to the 64-bit state, as SparkAvgDecimalStats
+// does. The sum and avg fields get the spark_sum and spark_avg result bounds, and
+// count lies in [0, max cardinality].
+static unique_ptr<BaseStatistics> SparkSumCountStats(ClientContext &context, BoundAggregateExpression &expr,
+                                                     AggregateStatisticsInput &input) {
+	auto stats = StructStats::CreateUnknown(expr.return_type);
+	auto count_stats = NumericStats::CreateUnknown(LogicalType::BIGINT);
+	NumericStats::SetMin(count_stats, Value::BIGINT(0));
+	if (input.node_stats && input.node_stats->has_max_cardinality &&
+	    input.node_stats->max_cardinality <= static_cast<idx_t>(NumericLimits<int64_t>::Maximum())) {
+		NumericStats::SetMax(count_stats, Value::BIGINT(static_cast<int64_t>(input.node_stats->max_cardinality)));
+	}
+	count_stats.Set(StatsInfo::CANNOT_HAVE_NULL_VALUES);
+	StructStats::SetChildStats(stats, 2, count_stats);
+
+	__int128 min_val, max_val;
+	if (TryGetDecimalStatsBounds(input.child_stats[0], min_val, max_val)) {
+		auto &input_type = expr.children[0]->return_type;
+		if (input_type.InternalType() == PhysicalType::INT128 && BoundsFitInt64(min_val, max_val)) {
+			SetSparkAggregateImplementation(expr.function,
+			                                GetSparkSumCountFunction<hugeint_t, SparkAvgDecimalNarrowState>());
+		}
+		auto sum_stats =
+		    SparkSumDecimalResultStats(StructType::GetChildType(expr.return_type, 0), min_val, max_val, input);
+		if (sum_stats) {
+			StructStats::SetChildStats(stats, 0, std::move(sum_stats));
+		}
+		auto avg_stats =
+		    SparkAvgDecimalResultStats(input_type, StructType::GetChildType(expr.return_type, 1), min_val, max_val);
+		if (avg_stats) {
+			StructStats::SetChildStats(stats, 1, std::move(avg_stats));
+		}
+	}
+	return stats.ToUnique();
+}
+
+inline AggregateFunction CreateSparkSumCountFunction() {
+	// Initial template uses hugeint_t; bind function swaps to the native input width
+	auto function = GetSparkSumCountFunction<hugeint_t>();
+	function.name = SPARK_SUM_COUNT_NAME;
+	function.bind = BindSparkSumCount;
+	function.statistics = SparkSumCountStats;
+	function.order_dependent = AggregateOrderDependent::NOT_ORDER_DEPENDENT;
+	return function;
+}
+
+inline AggregateFunctionSet CreateSparkSumCountFunctionSet() {
+	AggregateFunctionSet set(SPARK_SUM_COUNT_NAME);
+	set.AddFunction(CreateSparkSumCountFunction());
+	return set;
+}
+
+} // namespace duckdb
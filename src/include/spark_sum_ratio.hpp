@@ -0,0 +1,248 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "spark_aggregates.hpp"
+
+namespace duckdb {
+
+// ============================================================================
+// spark_sum_ratio: spark_sum(a) / spark_sum(b) as one aggregate
+//
+// Keeps both sums in one state, with the spark_sum states and callbacks for
+// each side (a NULL on one side still adds the other), and divides once per
+// group at finalize:
+//   sums:     DECIMAL(min(p+10, 38), s) each, as spark_sum (ComputeSumType)
+//   quotient: ComputeDivisionType of the two sum types, SparkDecimalDivide
+// A sum or quotient outside its precision is NULL, or an error in ANSI mode; a
+// zero or empty divisor sum is NULL. The result is therefore the same as the
+// unfused expression. The sum-ratio optimizer rule (spark_optimizer.cpp)
+// rewrites spark_sum(a) / spark_sum(b) into it.
+// ============================================================================
+
+static constexpr const char *SPARK_SUM_RATIO_NAME = "spark_sum_ratio";
+
+struct SparkSumRatioBindData : public FunctionData {
+	SparkDecimalResult sum_a;
+	SparkDecimalResult sum_b;
+	SparkDecimalResult result;
+	uint32_t scale_adj; // result.scale - sum_a.scale + sum_b.scale, as in spark_decimal_div
+	bool ansi;          // overflow of a result precision raises an error instead of returning NULL
+
+	SparkSumRatioBindData(const SparkDecimalResult &sum_a_p, const SparkDecimalResult &sum_b_p,
+	                      const SparkDecimalResult &result_p, bool ansi_p)
+	    : sum_a(sum_a_p), sum_b(sum_b_p), result(result_p),
+	      scale_adj(static_cast<uint32_t>(result_p.scale) - sum_a_p.scale + sum_b_p.scale), ansi(ansi_p) {
+	}
+
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<SparkSumRatioBindData>(sum_a, sum_b, result, ansi);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<SparkSumRatioBindData>();
+		return sum_a.precision == other.sum_a.precision && sum_a.scale == other.sum_a.scale &&
+		       sum_b.precision == other.sum_b.precision && sum_b.scale == other.sum_b.scale &&
+		       result.precision == other.result.precision && result.scale == other.result.scale &&
+		       ansi == other.ansi;
+	}
+};
+
+template <class A_STATE, class B_STATE>
+struct SparkSumRatioState {
+	typedef A_STATE LEFT_STATE;
+	typedef B_STATE RIGHT_STATE;
+
+	A_STATE a;
+	B_STATE b;
+};
+
+// The Spark overflow check of one DECIMAL value: false if it becomes NULL
+static inline bool SparkSumRatioInRange(__int128 val, const SparkDecimalResult &type, bool ansi) {
+	if (__builtin_expect(Abs128(val) >= Pow10_128(type.precision), 0)) {
+		if (ansi) {
+			ThrowSparkDecimalOverflow(LogicalType::DECIMAL(type.precision, type.scale));
+		}
+		return false;
+	}
+	return true;
+}
+
+struct SparkSumRatioOperation {
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.a.Initialize();
+		state.b.Initialize();
+	}
+
+	// Each side skips its own NULLs, as two separate spark_sum aggregates would
+	template <class A_TYPE, class B_TYPE, class STATE, class OP>
+	static void Operation(STATE &state, const A_TYPE &a, const B_TYPE &b, AggregateBinaryInput &input) {
+		if (input.left_mask.RowIsValid(input.lidx)) {
+			state.a.isset = true;
+			state.a.Add(a);
+		}
+		if (input.right_mask.RowIsValid(input.ridx)) {
+			state.b.isset = true;
+			state.b.Add(b);
+		}
+	}
+
+	template <class STATE, class OP>
+	static void Combine(const STATE &source, STATE &target, AggregateInputData &) {
+		target.a.Combine(source.a);
+		target.b.Combine(source.b);
+	}
+
+	template <class T, class STATE>
+	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
+		auto &bind_data = finalize_data.input.bind_data->Cast<SparkSumRatioBindData>();
+		// Both sums are checked, so ANSI mode raises for either one as spark_sum does
+		bool a_valid = state.a.isset && SparkSumRatioInRange(state.a.Value(), bind_data.sum_a, bind_data.ansi);
+		bool b_valid = state.b.isset && SparkSumRatioInRange(state.b.Value(), bind_data.sum_b, bind_data.ansi);
+		if (!a_valid || !b_valid) {
+			finalize_data.ReturnNull();
+			return;
+		}
+		__int128 divisor = state.b.Value();
+		if (divisor == 0) {
+			SparkCountAdd(SparkCounter::DIV_ZERO_DIVISOR_ROWS, 1);
+			finalize_data.ReturnNull();
+			return;
+		}
+		// scale_adj reaches 44 for a DECIMAL(38,38) divisor sum: SparkDivScale splits it
+		SparkDivScale scale(bind_data.scale_adj);
+		__int128 quotient = SparkDecimalDivide(state.a.Value(), divisor, scale.pow10_val, scale.pow10_extra);
+		if (!SparkSumRatioInRange(quotient, bind_data.result, bind_data.ansi)) {
+			SparkCountAdd(SparkCounter::DIV_OVERFLOW_ROWS, 1);
+			finalize_data.ReturnNull();
+			return;
+		}
+		WriteAggResult(target, quotient);
+	}
+
+	static bool IgnoreNull() {
+		return false;
+	}
+};
+
+// Grouped update: DuckDB's binary scatter loop, plus the per-vector row counters
+template <class STATE, class A_TYPE, class B_TYPE>
+static void SparkSumRatioScatterUpdate(Vector inputs[], AggregateInputData &aggr_input_data, idx_t input_count,
+                                       Vector &states, idx_t count) {
+	SparkCountAdd(STATE::LEFT_STATE::ROW_COUNTER, count);
+	SparkCountAdd(STATE::RIGHT_STATE::ROW_COUNTER, count);
+	AggregateFunction::BinaryScatterUpdate<STATE, A_TYPE, B_TYPE, SparkSumRatioOperation>(inputs, aggr_input_data,
+	                                                                                    input_count, states, count);
+}
+
+// Ungrouped update: each side block-sums its vector into its own spark_sum state
+template <class STATE, class A_TYPE, class B_TYPE>
+static void SparkSumRatioSimpleUpdate(Vector inputs[], AggregateInputData &aggr_input_data, idx_t input_count,
+                                      data_ptr_t state_p, idx_t count) {
+	D_ASSERT(input_count == 2);
+	auto &state = *reinterpret_cast<STATE *>(state_p);
+	SparkDecimalBlockSimpleUpdate<typename STATE::LEFT_STATE, A_TYPE>(inputs, aggr_input_data, 1,
+	                                                                  reinterpret_cast<data_ptr_t>(&state.a), count);
+	SparkDecimalBlockSimpleUpdate<typename STATE::RIGHT_STATE, B_TYPE>(inputs + 1, aggr_input_data, 1,
+	                                                                   reinterpret_cast<data_ptr_t>(&state.b), count);
+}
+
+template <class STATE>
+static aggregate_finalize_t GetSparkSumRatioFinalize(PhysicalType result_type) {
+	switch (result_type) {
+	case PhysicalType::INT16:
+		return AggregateFunction::StateFinalize<STATE, int16_t, SparkSumRatioOperation>;
+	case PhysicalType::INT32:
+		return AggregateFunction::StateFinalize<STATE, int32_t, SparkSumRatioOperation>;
+	case PhysicalType::INT64:
+		return AggregateFunction::StateFinalize<STATE, int64_t, SparkSumRatioOperation>;
+	case PhysicalType::INT128:
+		return AggregateFunction::StateFinalize<STATE, hugeint_t, SparkSumRatioOperation>;
+	default:
+		throw InternalException("Unexpected physical type for spark_sum_ratio DECIMAL result");
+	}
+}
+
+// Helper: create a spark_sum_ratio AggregateFunction for specific input/result physical types
+template <typename A_TYPE, typename B_TYPE>
+static AggregateFunction GetSparkSumRatioFunction(PhysicalType result_type) {
+	using STATE = SparkSumRatioState<typename SparkSumDecimalStateFor<A_TYPE>::type,
+	                                 typename SparkSumDecimalStateFor<B_TYPE>::type>;
+	auto function = AggregateFunction::BinaryAggregate<STATE, A_TYPE, B_TYPE, hugeint_t, SparkSumRatioOperation>(
+	    LogicalType::DECIMAL(38, 0), LogicalType::DECIMAL(38, 0), LogicalType::DECIMAL(38, 0));
+	function.update = SparkSumRatioScatterUpdate<STATE, A_TYPE, B_TYPE>;
+	function.simple_update = SparkSumRatioSimpleUpdate<STATE, A_TYPE, B_TYPE>;
+	function.finalize = GetSparkSumRatioFinalize<STATE>(result_type);
+	return function;
+}
+
+template <typename A_TYPE>
+static AggregateFunction GetSparkSumRatioFunction(PhysicalType b_type, PhysicalType result_type) {
+	switch (b_type) {
+	case PhysicalType::INT16:
+		return GetSparkSumRatioFunction<A_TYPE, int16_t>(result_type);
+	case PhysicalType::INT32:
+		return GetSparkSumRatioFunction<A_TYPE, int32_t>(result_type);
+	case PhysicalType::INT64:
+		return GetSparkSumRatioFunction<A_TYPE, int64_t>(result_type);
+	case PhysicalType::INT128:
+		return GetSparkSumRatioFunction<A_TYPE, hugeint_t>(result_type);
+	default:
+		throw InternalException("Unexpected physical type for spark_sum_ratio DECIMAL divisor");
+	}
+}
+
+static AggregateFunction GetSparkSumRatioFunction(PhysicalType a_type, PhysicalType b_type, PhysicalType result_type) {
+	switch (a_type) {
+	case PhysicalType::INT16:
+		return GetSparkSumRatioFunction<int16_t>(b_type, result_type);
+	case PhysicalType::INT32:
+		return GetSparkSumRatioFunction<int32_t>(b_type, result_type);
+	case PhysicalType::INT64:
+		return GetSparkSumRatioFunction<int64_t>(b_type, result_type);
+	case PhysicalType::INT128:
+		return GetSparkSumRatioFunction<hugeint_t>(b_type, result_type);
+	default:
+		throw InternalException("Unexpected physical type for spark_sum_ratio DECIMAL dividend");
+	}
+}
+
+static unique_ptr<FunctionData> BindSparkSumRatio(ClientContext &context, AggregateFunction &function,
+                                                  vector<unique_ptr<Expression>> &arguments) {
+	auto &type_a = arguments[0]->return_type;
+	auto &type_b = arguments[1]->return_type;
+	if (type_a.id() != LogicalTypeId::DECIMAL || type_b.id() != LogicalTypeId::DECIMAL) {
+		throw InvalidInputException("spark_sum_ratio requires DECIMAL arguments");
+	}
+
+	auto sum_a = ComputeSumType(DecimalType::GetWidth(type_a), DecimalType::GetScale(type_a));
+	auto sum_b = ComputeSumType(DecimalType::GetWidth(type_b), DecimalType::GetScale(type_b));
+	auto result = ComputeDivisionType(sum_a.precision, sum_a.scale, sum_b.precision, sum_b.scale);
+	auto result_type = LogicalType::DECIMAL(result.precision, result.scale);
+
+	// Take both inputs in their native width (no cast)
+	SetSparkAggregateImplementation(function, GetSparkSumRatioFunction(type_a.InternalType(), type_b.InternalType(),
+	                                                                   result_type.InternalType()));
+	function.arguments[0] = type_a;
+	function.arguments[1] = type_b;
+	function.return_type = result_type;
+
+	return make_uniq<SparkSumRatioBindData>(sum_a, sum_b, result, SparkAnsiEnabled(context));
+}
+
+inline AggregateFunction CreateSparkSumRatioFunction() {
+	// Initial template uses hugeint_t; bind function swaps to the native input widths
+	auto function = GetSparkSumRatioFunction<hugeint_t, hugeint_t>(PhysicalType::INT128);
+	function.name = SPARK_SUM_RATIO_NAME;
+	function.bind = BindSparkSumRatio;
+	function.order_dependent = AggregateOrderDependent::NOT_ORDER_DEPENDENT;
+	return function;
+}
+
+inline AggregateFunctionSet CreateSparkSumRatioFunctionSet() {
+	AggregateFunctionSet set(SPARK_SUM_RATIO_NAME);
+	set.AddFunction(CreateSparkSumRatioFunction());
+	return set;
+}
+
+} // namespace duckdb
@@ -20,6 +20,45 @@ inline hugeint_t Int128ToHugeint(__int128 v) {
 	return result;
 }
 
+// ---------------------------------------------------------------------------
+// DECIMAL physical type -> native integer
+// ---------------------------------------------------------------------------
+// DECIMAL values are stored as int16_t, int32_t, int64_t or hugeint_t depending
+// on their width. These helpers let kernels templated on the physical type read
+// the scaled integer without going through hugeint_t's checked conversions.
+
+template <typename T>
+inline __int128 DecimalToInt128(const T &v) {
+	return static_cast<__int128>(v);
+}
+
+template <>
+inline __int128 DecimalToInt128<hugeint_t>(const hugeint_t &v) {
+	return HugeintToInt128(v);
+}
+
+// Inverse of DecimalToInt128; the value must fit the physical type.
+template <typename T>
+inline T Int128ToDecimal(__int128 v) {
+	return static_cast<T>(v);
+}
+
+template <>
+inline hugeint_t Int128ToDecimal<hugeint_t>(__int128 v) {
+	return Int128ToHugeint(v);
+}
+
+// Caller guarantees the value fits in int64_t (always true for precision <= 18).
+template <typename T>
+inline int64_t DecimalToInt64(const T &v) {
+	return static_cast<int64_t>(v);
+}
+
+template <>
+inline int64_t DecimalToInt64<hugeint_t>(const hugeint_t &v) {
+	return static_cast<int64_t>(v.lower);
+}
+
 // ---------------------------------------------------------------------------
 // Absolute value for signed __int128
 // ---------------------------------------------------------------------------
@@ -65,21 +104,155 @@ inline uint256_t Mul128(unsigned __int128 a, unsigned __int128 b) {
 	return {hi, lo};
 }
 
+inline uint256_t Add256(const uint256_t &a, const uint256_t &b) {
+	unsigned __int128 lo = a.lo + b.lo;
+	return {a.hi + b.hi + (lo < a.lo ? 1 : 0), lo};
+}
+
+// a - b, requires a >= b
+inline uint256_t Sub256(const uint256_t &a, const uint256_t &b) {
+	return {a.hi - b.hi - (a.lo < b.lo ? 1 : 0), a.lo - b.lo};
+}
+
+inline bool LessThan256(const uint256_t &a, const uint256_t &b) {
+	return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo);
+}
+
+// ---------------------------------------------------------------------------
+// Word-level long division on 64-bit limbs
+// ---------------------------------------------------------------------------
+
+// Divide the 128-bit value (hi * 2^64 + lo) by d, returning the 64-bit quotient.
+// Requires hi < d so that the quotient fits in 64 bits. On x86-64 this is a
+// single `divq`; elsewhere the compiler's 128/64 division is used.
+inline uint64_t Div128By64(uint64_t hi, uint64_t lo, uint64_t d, uint64_t *remainder) {
+	D_ASSERT(hi < d);
+#if defined(__x86_64__)
+	uint64_t quot;
+	uint64_t rem;
+	__asm__("divq %[d]" : "=a"(quot), "=d"(rem) : [d] "r"(d), "a"(lo), "d"(hi));
+	*remainder = rem;
+	return quot;
+#else
+	unsigned __int128 n = (static_cast<unsigned __int128>(hi) << 64) | lo;
+	*remainder = static_cast<uint64_t>(n % d);
+	return static_cast<uint64_t>(n / d);
+#endif
+}
+
+// Maximum number of 64-bit limbs supported by DivModLimbs (256-bit operands).
+static constexpr uint32_t WIDE_MAX_LIMBS = 4;
+
+// Knuth, TAOCP vol. 2, section 4.3.1, Algorithm D, on little-endian 64-bit limbs.
+//
+// u has m limbs, v has n limbs with 2 <= n <= m <= WIDE_MAX_LIMBS and v[n-1] != 0.
+// Writes the m - n + 1 quotient limbs to q and the n remainder limbs to r.
+// The divisor is normalized so that its top bit is set; each quotient limb is
+// then estimated with one 128/64 division and corrected at most twice.
+inline void DivModLimbs(const uint64_t *u, uint32_t m, const uint64_t *v, uint32_t n, uint64_t *q, uint64_t *r) {
+	D_ASSERT(n >= 2 && n <= m && m <= WIDE_MAX_LIMBS && v[n - 1] != 0);
+
+	// D1: normalize
+	uint32_t shift = static_cast<uint32_t>(__builtin_clzll(v[n - 1]));
+	uint64_t vn[WIDE_MAX_LIMBS];
+	uint64_t un[WIDE_MAX_LIMBS + 1];
+	for (uint32_t i = n - 1; i > 0; i--) {
+		vn[i] = (v[i] << shift) | (shift ? v[i - 1] >> (64 - shift) : 0);
+	}
+	vn[0] = v[0] << shift;
+	un[m] = shift ? u[m - 1] >> (64 - shift) : 0;
+	for (uint32_t i = m - 1; i > 0; i--) {
+		un[i] = (u[i] << shift) | (shift ? u[i - 1] >> (64 - shift) : 0);
+	}
+	un[0] = u[0] << shift;
+
+	const uint64_t v_top = vn[n - 1];
+	const uint64_t v_next = vn[n - 2];
+
+	for (uint32_t j = m - n + 1; j-- > 0;) {
+		// D3: estimate qhat from the top two limbs of the current remainder
+		uint64_t u_top = un[j + n];
+		uint64_t u_next = un[j + n - 1];
+		uint64_t qhat;
+		unsigned __int128 rhat;
+		if (u_top < v_top) {
+			uint64_t rhat64;
+			qhat = Div128By64(u_top, u_next, v_top, &rhat64);
+			rhat = rhat64;
+		} else {
+			// u_top == v_top: the estimate saturates at 2^64 - 1
+			qhat = ~static_cast<uint64_t>(0);
+			rhat = static_cast<unsigned __int128>(u_next) + v_top;
+		}
+		while ((rhat >> 64) == 0 &&
+		       static_cast<unsigned __int128>(qhat) * v_next > ((rhat << 64) | un[j + n - 2])) {
+			qhat--;
+			rhat += v_top;
+		}
+
+		// D4: multiply and subtract qhat * vn from un[j .. j+n]
+		uint64_t carry = 0;
+		uint64_t borrow = 0;
+		for (uint32_t i = 0; i < n; i++) {
+			unsigned __int128 p = static_cast<unsigned __int128>(qhat) * vn[i] + carry;
+			carry = static_cast<uint64_t>(p >> 64);
+			uint64_t p_lo = static_cast<uint64_t>(p);
+			uint64_t before = un[i + j];
+			uint64_t diff = before - p_lo;
+			uint64_t borrow1 = before < p_lo;
+			un[i + j] = diff - borrow;
+			borrow = borrow1 + (diff < borrow);
+		}
+		unsigned __int128 sub = static_cast<unsigned __int128>(carry) + borrow;
+		bool negative = un[j + n] < sub;
+		un[j + n] = static_cast<uint64_t>(un[j + n] - sub);
+
+		// D6: add back (probability ~2/2^64)
+		if (__builtin_expect(negative, 0)) {
+			qhat--;
+			uint64_t c = 0;
+			for (uint32_t i = 0; i < n; i++) {
+				unsigned __int128 sum = static_cast<unsigned __int128>(un[i + j]) + vn[i] + c;
+				un[i + j] = static_cast<uint64_t>(sum);
+				c = static_cast<uint64_t>(sum >> 64);
+			}
+			un[j + n] += c;
+		}
+		q[j] = qhat;
+	}
+
+	// D8: un-normalize the remainder
+	for (uint32_t i = 0; i < n; i++) {
+		r[i] = (un[i] >> shift) | (shift ? un[i + 1] << (64 - shift) : 0);
+	}
+}
+
 // Divide a 256-bit unsigned value by a 128-bit unsigned divisor.
-// Returns quotient (must fit in 128 bits) and sets *remainder.
+// Returns the quotient and sets *remainder.
 //
-// Uses two-step decomposition: treat the 256-bit numerator as (hi * 2^128 + lo),
-// then compute quotient and remainder via two 128-bit divisions. This avoids
-// the 256-iteration bit-by-bit loop of the naive approach.
+// Treat the 256-bit numerator as (hi * 2^128 + lo). The quotient fits in
+// 128 bits iff hi < den. Otherwise it saturates to 2^128 - 1, which callers
+// detect with the same hi >= den test; the remainder stays exact because
+// (hi * 2^128 + lo) mod den == ((hi mod den) * 2^128 + lo) mod den.
+// The algorithm is selected at runtime from the operand sizes:
 //
-// Step 1: hi / den = q_hi, r_hi  (q_hi must be 0 for result to fit in 128 bits)
-// Step 2: (r_hi * 2^128 + lo) / den = q_lo, r_lo
+//   hi == 0          -> native 128/128 division
+//   den < 2^64       -> two chained 128/64 `divq` steps (schoolbook, one digit each)
+//   otherwise        -> Knuth Algorithm D with two 64-bit divisor limbs
 //
-// Step 2 requires dividing a value that can be up to 256 bits by a 128-bit divisor.
-// We decompose it further using 64-bit limbs when the intermediate values exceed
-// 128 bits, falling back to the hardware's native 128-bit division.
+// All paths do a constant number of word operations, replacing the
+// 128-iteration shift-subtract loop.
 inline unsigned __int128 Div256By128(uint256_t num, unsigned __int128 den,
                                      unsigned __int128 *remainder) {
+	// Quotient beyond 128 bits: the long division below would trap (`divq`
+	// raises #DE when its quotient does not fit), so divide the reduced value
+	// for the remainder and saturate the quotient
+	if (__builtin_expect(num.hi >= den, 0)) {
+		num.hi %= den;
+		Div256By128(num, den, remainder);
+		return ~static_cast<unsigned __int128>(0);
+	}
+
 	// If hi < den, we can skip step 1 (q_hi = 0, r_hi = hi)
 	if (num.hi == 0) {
 		// Simple case: 128-bit / 128-bit
@@ -90,74 +263,95 @@ inline unsigned __int128 Div256By128(uint256_t num, unsigned __int128 den,
 		return quot;
 	}
 
-	// Step 1: divide hi by den
-	D_ASSERT(num.hi < den); // quotient must fit in 128 bits
-	unsigned __int128 r_hi = num.hi;
-
-	// Step 2: divide (r_hi * 2^128 + lo) by den
-	// We need to handle this carefully since r_hi * 2^128 doesn't fit in 128 bits.
-	// Decompose using 64-bit halves of lo.
-	//
-	// Let lo = lo_hi * 2^64 + lo_lo
-	// (r_hi * 2^128 + lo) = (r_hi * 2^64 + lo_hi) * 2^64 + lo_lo
-	//
-	// Step 2a: (r_hi * 2^64 + lo_hi) / den = q2a, r2a
-	//   But r_hi * 2^64 + lo_hi can exceed 128 bits if r_hi >= 2^64.
-	//   However, we know r_hi < den, and we work with the 64-bit halves.
-
 	uint64_t lo_hi = static_cast<uint64_t>(num.lo >> 64);
 	uint64_t lo_lo = static_cast<uint64_t>(num.lo);
 
-	// Compute (r_hi * 2^64 + lo_hi) as a 192-bit value, then divide by den.
-	// Since r_hi < den (128-bit), r_hi * 2^64 needs up to 192 bits.
-	// We use iterative 64-bit digit extraction.
-
-	// Process the upper 64-bit digit of lo:
-	// Form the 192-bit value: (r_hi << 64) | lo_hi, divide by den
-	// This is equivalent to: remainder * 2^64 + next_digit, iterated.
-
-	// Shift remainder up by 64 bits and add lo_hi
-	// r_hi is < den, so (r_hi << 64 + lo_hi) may be > 2^128.
-	// We handle this by noting that if r_hi < den, then after dividing
-	// (r_hi * 2^64 + lo_hi) by den, the quotient fits in 64 bits.
-
-	// Use the identity: (A * 2^64 + B) / D where A < D (128-bit)
-	// q = 0 or 1 iteration of subtract-and-shift won't work directly.
-	// Instead, use schoolbook division on 64-bit limbs.
-
-	// For correctness with arbitrary 128-bit divisors, fall back to
-	// binary long division but only over the significant bits.
-	unsigned __int128 quot = 0;
-	unsigned __int128 rem = r_hi;
-
-	// Process the upper 64 bits of lo
-	for (int32_t bit = 63; bit >= 0; bit--) {
-		rem <<= 1;
-		if (lo_hi & (static_cast<uint64_t>(1) << bit)) {
-			rem |= 1;
-		}
-		if (rem >= den) {
-			rem -= den;
-			quot |= (static_cast<unsigned __int128>(1) << (bit + 64));
+	if ((den >> 64) == 0) {
+		// 64-bit divisor: hi < den < 2^64, so each step's quotient fits in 64 bits
+		uint64_t d = static_cast<uint64_t>(den);
+		uint64_t rem = static_cast<uint64_t>(num.hi);
+		uint64_t q_hi = Div128By64(rem, lo_hi, d, &rem);
+		uint64_t q_lo = Div128By64(rem, lo_lo, d, &rem);
+		if (remainder) {
+			*remainder = rem;
 		}
+		return (static_cast<unsigned __int128>(q_hi) << 64) | q_lo;
 	}
 
-	// Process the lower 64 bits of lo
-	for (int32_t bit = 63; bit >= 0; bit--) {
-		rem <<= 1;
-		if (lo_lo & (static_cast<uint64_t>(1) << bit)) {
-			rem |= 1;
-		}
-		if (rem >= den) {
-			rem -= den;
-			quot |= (static_cast<unsigned __int128>(1) << bit);
-		}
-	}
+	const uint64_t u[4] = {lo_lo, lo_hi, static_cast<uint64_t>(num.hi), static_cast<uint64_t>(num.hi >> 64)};
+	const uint64_t v[2] = {static_cast<uint64_t>(den), static_cast<uint64_t>(den >> 64)};
+	uint64_t q[3];
+	uint64_t r[2];
+	DivModLimbs(u, 4, v, 2, q, r);
+	D_ASSERT(q[2] == 0);
 
 	if (remainder) {
-		*remainder = rem;
+		*remainder = (static_cast<unsigned __int128>(r[1]) << 64) | r[0];
 	}
-	return quot;
+	return (static_cast<unsigned __int128>(q[1]) << 64) | q[0];
+}
+
+// ---------------------------------------------------------------------------
+// Division by an invariant divisor via multiply-and-shift
+// ---------------------------------------------------------------------------
+// Granlund & Montgomery, "Division by Invariant Integers using Multiplication"
+// (Figure 4.1), the same scheme libdivide uses for its branchfree divisors.
+// For an N-bit divisor d >= 1 with l = ceil(log2(d)):
+//
+//   m   = floor(2^N * (2^l - d) / d) + 1     (always fits in N bits)
+//   sh1 = min(l, 1),  sh2 = max(l - 1, 0)
+//
+// and for every N-bit dividend n:
+//
+//   t = mulhi(m, n);  n / d = (t + ((n - t) >> sh1)) >> sh2
+//
+// The quotient is exact, so the remainder n - q * d is exact as well.
+
+inline uint32_t CountLeadingZeros128(unsigned __int128 x) {
+	D_ASSERT(x != 0);
+	uint64_t hi = static_cast<uint64_t>(x >> 64);
+	return hi != 0 ? static_cast<uint32_t>(__builtin_clzll(hi))
+	               : 64 + static_cast<uint32_t>(__builtin_clzll(static_cast<uint64_t>(x)));
+}
+
+struct Reciprocal64 {
+	uint64_t multiplier;
+	uint8_t shift1;
+	uint8_t shift2;
+};
+
+struct Reciprocal128 {
+	unsigned __int128 multiplier;
+	uint8_t shift1;
+	uint8_t shift2;
+};
+
+inline Reciprocal64 MakeReciprocal64(uint64_t d) {
+	D_ASSERT(d != 0);
+	uint32_t l = d == 1 ? 0 : 64 - static_cast<uint32_t>(__builtin_clzll(d - 1));
+	// 2^l - d, computed modulo 2^64 so that l == 64 needs no special case
+	uint64_t pow2_minus_d = (l == 64 ? 0 : (static_cast<uint64_t>(1) << l)) - d;
+	uint64_t m = static_cast<uint64_t>((static_cast<unsigned __int128>(pow2_minus_d) << 64) / d) + 1;
+	return {m, static_cast<uint8_t>(l > 0 ? 1 : 0), static_cast<uint8_t>(l > 0 ? l - 1 : 0)};
+}
+
+inline uint64_t DivideByReciprocal(uint64_t n, const Reciprocal64 &rcp) {
+	uint64_t t = static_cast<uint64_t>((static_cast<unsigned __int128>(rcp.multiplier) * n) >> 64);
+	return (t + ((n - t) >> rcp.shift1)) >> rcp.shift2;
+}
+
+inline Reciprocal128 MakeReciprocal128(unsigned __int128 d) {
+	D_ASSERT(d != 0);
+	uint32_t l = d == 1 ? 0 : 128 - CountLeadingZeros128(d - 1);
+	unsigned __int128 pow2_minus_d = (l == 128 ? 0 : (static_cast<unsigned __int128>(1) << l)) - d;
+	// 2^l < 2d, so pow2_minus_d < d and the quotient fits in 128 bits
+	unsigned __int128 m = Div256By128({pow2_minus_d, 0}, d, nullptr) + 1;
+	return {m, static_cast<uint8_t>(l > 0 ? 1 : 0), static_cast<uint8_t>(l > 0 ? l - 1 : 0)};
+}
+
+inline unsigned __int128 DivideByReciprocal(unsigned __int128 n, const Reciprocal128 &rcp) {
+	unsigned __int128 t = Mul128(rcp.multiplier, n).hi;
+	return (t + ((n - t) >> rcp.shift1)) >> rcp.shift2;
 }
 
 // ---------------------------------------------------------------------------
@@ -169,6 +363,12 @@ inline constexpr unsigned __int128 MakeUint128(uint64_t hi, uint64_t lo) {
 	return (static_cast<unsigned __int128>(hi) << 64) | lo;
 }
 
+// 10^exp as a constant expression, for exponents fixed at compile time
+// (template arguments); runtime exponents use the Pow10_128 table below.
+inline constexpr unsigned __int128 Pow10Constexpr(uint32_t exp) {
+	return exp == 0 ? 1 : 10 * Pow10Constexpr(exp - 1);
+}
+
 // O(1) lookup table covering 10^0 through 10^38.
 // D_ASSERT guards against out-of-range exponents.
 inline unsigned __int128 Pow10_128(uint32_t exp) {
@@ -0,0 +1,350 @@
+#include "spark_arithmetic.hpp"
+#include "spark_counters.hpp"
+#include "spark_ansi.hpp"
+
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/scalar_function_catalog_entry.hpp"
+#include "duckdb/catalog/catalog_entry/schema_catalog_entry.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/types/decimal.hpp"
+#include "duckdb/function/scalar_function.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+
+namespace duckdb {
+
+// ---------------------------------------------------------------------------
+// Write helpers: convert __int128 to target physical type
+// ---------------------------------------------------------------------------
+
+template <typename T>
+static inline void WriteResult(T *data, idx_t idx, __int128 val) {
+	data[idx] = static_cast<T>(val);
+}
+
+template <>
+inline void WriteResult<hugeint_t>(hugeint_t *data, idx_t idx, __int128 val) {
+	data[idx] = Int128ToHugeint(val);
+}
+
+// ---------------------------------------------------------------------------
+// Per-row operators
+// ---------------------------------------------------------------------------
+
+struct SparkMulOp {
+	static constexpr const char *NAME = "spark_decimal_mul";
+	static constexpr const char *OPERATOR = "*";
+
+	static SparkDecimalResult ResultType(uint8_t p1, uint8_t s1, uint8_t p2, uint8_t s2) {
+		return ComputeMultiplyType(p1, s1, p2, s2);
+	}
+	static SparkArithParams Params(uint8_t s1, uint8_t s2, const SparkDecimalResult &result) {
+		return MakeSparkMultiplyParams(s1, s2, result);
+	}
+	static bool Operation(__int128 a, __int128 b, const SparkArithParams &params, __int128 &result) {
+		return SparkDecimalMultiply(a, b, params, result);
+	}
+};
+
+struct SparkAddOp {
+	static constexpr const char *NAME = "spark_decimal_add";
+	static constexpr const char *OPERATOR = "+";
+
+	static SparkDecimalResult ResultType(uint8_t p1, uint8_t s1, uint8_t p2, uint8_t s2) {
+		return ComputeAddSubtractType(p1, s1, p2, s2);
+	}
+	static SparkArithParams Params(uint8_t s1, uint8_t s2, const SparkDecimalResult &result) {
+		return MakeSparkAddSubtractParams(s1, s2, result);
+	}
+	static bool Operation(__int128 a, __int128 b, const SparkArithParams &params, __int128 &result) {
+		return SparkDecimalAdd(a, b, params, result);
+	}
+};
+
+struct SparkSubOp {
+	static constexpr const char *NAME = "spark_decimal_sub";
+	static constexpr const char *OPERATOR = "-";
+
+	static SparkDecimalResult ResultType(uint8_t p1, uint8_t s1, uint8_t p2, uint8_t s2) {
+		return ComputeAddSubtractType(p1, s1, p2, s2);
+	}
+	static SparkArithParams Params(uint8_t s1, uint8_t s2, const SparkDecimalResult &result) {
+		return MakeSparkAddSubtractParams(s1, s2, result);
+	}
+	static bool Operation(__int128 a, __int128 b, const SparkArithParams &params, __int128 &result) {
+		return SparkDecimalSubtract(a, b, params, result);
+	}
+};
+
+// ---------------------------------------------------------------------------
+// Execution: rows whose result overflows the result precision become NULL
+// ---------------------------------------------------------------------------
+// The operators already report overflow per row (it falls out of the 128/256-bit
+// arithmetic), so the loop only counts it; ANSI mode raises once per vector.
+
+template <typename A_TYPE, typename B_TYPE, typename RESULT_TYPE, typename OP>
+static void SparkArithExec(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &bind_data = func_expr.bind_info->Cast<SparkArithBindData>();
+	auto &params = bind_data.params;
+	auto &a = args.data[0];
+	auto &b = args.data[1];
+	idx_t count = args.size();
+	SparkCountAdd(SparkCounter::ARITH_ROWS, count);
+
+	if (a.GetVectorType() == VectorType::CONSTANT_VECTOR && b.GetVectorType() == VectorType::CONSTANT_VECTOR) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+		if (ConstantVector::IsNull(a) || ConstantVector::IsNull(b)) {
+			ConstantVector::SetNull(result, true);
+			return;
+		}
+		__int128 value;
+		if (!OP::Operation(DecimalToInt128(*ConstantVector::GetData<A_TYPE>(a)),
+		                   DecimalToInt128(*ConstantVector::GetData<B_TYPE>(b)), params, value)) {
+			if (bind_data.ansi) {
+				ThrowSparkDecimalOverflow(result.GetType());
+			}
+			SparkCountAdd(SparkCounter::ARITH_OVERFLOW_ROWS, count);
+			ConstantVector::SetNull(result, true);
+			return;
+		}
+		WriteResult(ConstantVector::GetData<RESULT_TYPE>(result), 0, value);
+		return;
+	}
+
+	UnifiedVectorFormat a_data, b_data;
+	a.ToUnifiedFormat(count, a_data);
+	b.ToUnifiedFormat(count, b_data);
+	auto a_ptr = UnifiedVectorFormat::GetData<A_TYPE>(a_data);
+	auto b_ptr = UnifiedVectorFormat::GetData<B_TYPE>(b_data);
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<RESULT_TYPE>(result);
+	auto &result_validity = FlatVector::Validity(result);
+
+	idx_t overflow_count = 0;
+	for (idx_t i = 0; i < count; i++) {
+		auto a_idx = a_data.sel->get_index(i);
+		auto b_idx = b_data.sel->get_index(i);
+		if (!a_data.validity.RowIsValid(a_idx) || !b_data.validity.RowIsValid(b_idx)) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		__int128 value;
+		if (!OP::Operation(DecimalToInt128(a_ptr[a_idx]), DecimalToInt128(b_ptr[b_idx]), params, value)) {
+			result_validity.SetInvalid(i);
+			overflow_count++;
+			continue;
+		}
+		WriteResult(result_data, i, value);
+	}
+	if (overflow_count > 0 && bind_data.ansi) {
+		ThrowSparkDecimalOverflow(result.GetType());
+	}
+	SparkCountAdd(SparkCounter::ARITH_OVERFLOW_ROWS, overflow_count);
+}
+
+// ---------------------------------------------------------------------------
+// Kernel selection: one instantiation per (input, input, result) physical type
+// ---------------------------------------------------------------------------
+
+template <typename A_TYPE, typename B_TYPE, typename OP>
+static scalar_function_t GetSparkArithKernel(PhysicalType result_type) {
+	switch (result_type) {
+	case PhysicalType::INT16:
+		return SparkArithExec<A_TYPE, B_TYPE, int16_t, OP>;
+	case PhysicalType::INT32:
+		return SparkArithExec<A_TYPE, B_TYPE, int32_t, OP>;
+	case PhysicalType::INT64:
+		return SparkArithExec<A_TYPE, B_TYPE, int64_t, OP>;
+	case PhysicalType::INT128:
+		return SparkArithExec<A_TYPE, B_TYPE, hugeint_t, OP>;
+	default:
+		throw InternalException("Unexpected physical type for DECIMAL result");
+	}
+}
+
+template <typename A_TYPE, typename OP>
+static scalar_function_t GetSparkArithKernel(PhysicalType b_type, PhysicalType result_type) {
+	switch (b_type) {
+	case PhysicalType::INT16:
+		return GetSparkArithKernel<A_TYPE, int16_t, OP>(result_type);
+	case PhysicalType::INT32:
+		return GetSparkArithKernel<A_TYPE, int32_t, OP>(result_type);
+	case PhysicalType::INT64:
+		return GetSparkArithKernel<A_TYPE, int64_t, OP>(result_type);
+	case PhysicalType::INT128:
+		return GetSparkArithKernel<A_TYPE, hugeint_t, OP>(result_type);
+	default:
+		throw InternalException("Unexpected physical type for DECIMAL operand");
+	}
+}
+
+template <typename OP>
+static scalar_function_t GetSparkArithKernel(PhysicalType a_type, PhysicalType b_type, PhysicalType result_type) {
+	switch (a_type) {
+	case PhysicalType::INT16:
+		return GetSparkArithKernel<int16_t, OP>(b_type, result_type);
+	case PhysicalType::INT32:
+		return GetSparkArithKernel<int32_t, OP>(b_type, result_type);
+	case PhysicalType::INT64:
+		return GetSparkArithKernel<int64_t, OP>(b_type, result_type);
+	case PhysicalType::INT128:
+		return GetSparkArithKernel<hugeint_t, OP>(b_type, result_type);
+	default:
+		throw InternalException("Unexpected physical type for DECIMAL operand");
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Bind function: resolve types and select implementation
+// ---------------------------------------------------------------------------
+
+// DECIMAL type of an operand. Integer operands are widened the way Spark does
+// (DecimalType.forType): TINYINT -> (3,0), SMALLINT -> (5,0), INTEGER -> (10,0),
+// BIGINT -> (20,0).
+static LogicalType SparkDecimalOperandType(const LogicalType &type, const char *name) {
+	if (type.id() == LogicalTypeId::DECIMAL) {
+		return type;
+	}
+	if (type.id() == LogicalTypeId::BIGINT) {
+		return LogicalType::DECIMAL(20, 0);
+	}
+	uint8_t width, scale;
+	if (!type.GetDecimalProperties(width, scale)) {
+		throw InvalidInputException("%s requires DECIMAL or integer arguments, got %s", name, type.ToString());
+	}
+	return LogicalType::DECIMAL(width, scale);
+}
+
+template <typename OP>
+static unique_ptr<FunctionData> BindSparkDecimalArith(ClientContext &context, ScalarFunction &bound_function,
+                                                      vector<unique_ptr<Expression>> &arguments) {
+	// Integer operands get an implicit cast to DECIMAL; DECIMAL operands keep
+	// their declared type and the kernel is templated on the physical types.
+	auto type_a = SparkDecimalOperandType(arguments[0]->return_type, OP::NAME);
+	auto type_b = SparkDecimalOperandType(arguments[1]->return_type, OP::NAME);
+	bound_function.arguments[0] = type_a;
+	bound_function.arguments[1] = type_b;
+
+	uint8_t p1 = DecimalType::GetWidth(type_a);
+	uint8_t s1 = DecimalType::GetScale(type_a);
+	uint8_t p2 = DecimalType::GetWidth(type_b);
+	uint8_t s2 = DecimalType::GetScale(type_b);
+
+	auto result = OP::ResultType(p1, s1, p2, s2);
+	auto result_type = LogicalType::DECIMAL(result.precision, result.scale);
+	bound_function.return_type = result_type;
+	bound_function.function =
+	    GetSparkArithKernel<OP>(type_a.InternalType(), type_b.InternalType(), result_type.InternalType());
+
+	return make_uniq<SparkArithBindData>(OP::Params(s1, s2, result), SparkAnsiEnabled(context));
+}
+
+// ---------------------------------------------------------------------------
+// Registration
+// ---------------------------------------------------------------------------
+
+template <typename OP>
+static ScalarFunction GetSparkArithFunction(const string &name) {
+	ScalarFunction func(name, {LogicalType::ANY, LogicalType::ANY}, LogicalType::ANY,
+	                    SparkArithExec<hugeint_t, hugeint_t, hugeint_t, OP>, BindSparkDecimalArith<OP>);
+	func.null_handling = FunctionNullHandling::SPECIAL_HANDLING;
+	return func;
+}
+
+// Unlike `/`, the built-in `*`, `+` and `-` already have a generic
+// (DECIMAL, DECIMAL) overload, and adding a second DECIMAL overload next to it
+// would make overload resolution ambiguous. The operator's catalog entry is
+// therefore replaced (CREATE OR REPLACE in the system transaction) by a copy of
+// its overloads in which the DECIMAL one is ours, keeping its argument
+// signature so that resolution (and the implicit casts of integer operands) is
+// unchanged.
+
+// The built-in (DECIMAL, DECIMAL) overload that was replaced, bound instead
+// when spark_decimal_operators is off. The same for every database instance.
+template <typename OP>
+static unique_ptr<ScalarFunction> &BuiltinDecimalOperator() {
+	static unique_ptr<ScalarFunction> builtin;
+	return builtin;
+}
+
+static bool SparkDecimalOperatorsEnabled(ClientContext &context) {
+	Value value;
+	if (!context.TryGetCurrentSetting(SPARK_DECIMAL_OPERATORS_SETTING, value) || value.IsNull()) {
+		return true;
+	}
+	return BooleanValue::Get(value);
+}
+
+template <typename OP>
+static unique_ptr<FunctionData> BindSparkDecimalOperator(ClientContext &context, ScalarFunction &bound_function,
+                                                         vector<unique_ptr<Expression>> &arguments) {
+	auto &builtin = BuiltinDecimalOperator<OP>();
+	if (builtin && !SparkDecimalOperatorsEnabled(context)) {
+		bound_function = *builtin;
+		return bound_function.bind ? bound_function.bind(context, bound_function, arguments) : nullptr;
+	}
+	return BindSparkDecimalArith<OP>(context, bound_function, arguments);
+}
+
+template <typename OP>
+static void OverrideDecimalOperator(ExtensionLoader &loader) {
+	auto func = GetSparkArithFunction<OP>(OP::OPERATOR);
+	func.bind = BindSparkDecimalOperator<OP>;
+	auto &db = loader.GetDatabaseInstance();
+	auto &system_catalog = Catalog::GetSystemCatalog(db);
+	auto transaction = CatalogTransaction::GetSystemTransaction(db);
+	auto &schema = system_catalog.GetSchema(transaction, DEFAULT_SCHEMA);
+	auto catalog_entry = schema.GetEntry(transaction, CatalogType::SCALAR_FUNCTION_ENTRY, OP::OPERATOR);
+	if (!catalog_entry) {
+		func.arguments = {LogicalType::DECIMAL(38, 0), LogicalType::DECIMAL(38, 0)};
+		loader.AddFunctionOverload(func);
+		return;
+	}
+
+	ScalarFunctionSet overloads(OP::OPERATOR);
+	bool replaced = false;
+	for (auto &existing : catalog_entry->Cast<ScalarFunctionCatalogEntry>().functions.functions) {
+		if (!replaced && existing.arguments.size() == 2 && existing.arguments[0].id() == LogicalTypeId::DECIMAL &&
+		    existing.arguments[1].id() == LogicalTypeId::DECIMAL) {
+			if (!BuiltinDecimalOperator<OP>()) {
+				BuiltinDecimalOperator<OP>() = make_uniq<ScalarFunction>(existing);
+			}
+			func.arguments = existing.arguments;
+			overloads.AddFunction(func);
+			replaced = true;
+		} else {
+			overloads.AddFunction(existing);
+		}
+	}
+	if (!replaced) {
+		func.arguments = {LogicalType::DECIMAL(38, 0), LogicalType::DECIMAL(38, 0)};
+		overloads.AddFunction(func);
+	}
+	CreateScalarFunctionInfo info(std::move(overloads));
+	info.on_conflict = OnCreateConflict::REPLACE_ON_CONFLICT;
+	info.internal = true;
+	system_catalog.CreateFunction(transaction, info);
+}
+
+void RegisterSparkArithmeticFunctions(ExtensionLoader &loader) {
+	loader.RegisterFunction(GetSparkArithFunction<SparkMulOp>(SparkMulOp::NAME));
+	loader.RegisterFunction(GetSparkArithFunction<SparkAddOp>(SparkAddOp::NAME));
+	loader.RegisterFunction(GetSparkArithFunction<SparkSubOp>(SparkSubOp::NAME));
+
+	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+	config.AddExtensionOption(SPARK_DECIMAL_OPERATORS_SETTING,
+	                          "Give the DECIMAL `*`, `+` and `-` operators Spark semantics (result type, HALF_UP "
+	                          "rounding, overflow to NULL); off binds DuckDB's own DECIMAL arithmetic",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(true));
+
+	OverrideDecimalOperator<SparkMulOp>(loader);
+	OverrideDecimalOperator<SparkAddOp>(loader);
+	OverrideDecimalOperator<SparkSubOp>(loader);
+}
+
+} // namespace duckdb
@@ -0,0 +1,198 @@
+#include "spark_decimal_string.hpp"
+#include "spark_precision.hpp"
+#include "spark_ansi.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/types/decimal.hpp"
+#include "duckdb/common/vector_operations/unary_executor.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/function/scalar_function.hpp"
+#include "duckdb/function/function_set.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+
+namespace duckdb {
+
+// ---------------------------------------------------------------------------
+// spark_cast_decimal(varchar [, precision, scale])
+// ---------------------------------------------------------------------------
+// Invalid strings and values that do not fit DECIMAL(p, s) are NULL, or an
+// error in ANSI mode.
+
+struct SparkCastDecimalBindData : public FunctionData {
+	uint8_t precision;
+	uint8_t scale;
+	bool ansi;
+
+	SparkCastDecimalBindData(uint8_t precision_p, uint8_t scale_p, bool ansi_p)
+	    : precision(precision_p), scale(scale_p), ansi(ansi_p) {
+	}
+
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<SparkCastDecimalBindData>(precision, scale, ansi);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<SparkCastDecimalBindData>();
+		return precision == other.precision && scale == other.scale && ansi == other.ansi;
+	}
+};
+
+template <typename RESULT_TYPE>
+static void SparkCastDecimalVector(Vector &source, Vector &result, idx_t count,
+                                   const SparkCastDecimalBindData &bind_data) {
+	UnaryExecutor::ExecuteWithNulls<string_t, RESULT_TYPE>(
+	    source, result, count, [&](string_t input, ValidityMask &mask, idx_t idx) {
+		    __int128 value;
+		    auto status =
+		        SparkParseDecimal(input.GetData(), input.GetSize(), bind_data.precision, bind_data.scale, value);
+		    if (__builtin_expect(status != SparkDecimalParseResult::SUCCESS, 0)) {
+			    if (bind_data.ansi) {
+				    if (status == SparkDecimalParseResult::OUT_OF_RANGE) {
+					    ThrowSparkDecimalOverflow(result.GetType());
+				    }
+				    throw ConversionException("CAST_INVALID_INPUT: the value '%s' cannot be cast to %s because it is "
+				                              "malformed (set %s = false to return NULL instead)",
+				                              input.GetString(), result.GetType().ToString(), SPARK_ANSI_SETTING);
+			    }
+			    mask.SetInvalid(idx);
+			    return RESULT_TYPE(0);
+		    }
+		    return Int128ToDecimal<RESULT_TYPE>(value);
+	    });
+}
+
+// A dictionary input (a low-cardinality string column from a dictionary-
+// compressed scan) is parsed once per entry, and the result stays a dictionary
+// over the parsed values. Not in ANSI mode, where an invalid entry that no row
+// references must not raise an error.
+template <typename RESULT_TYPE>
+static void SparkCastDecimalExec(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &bind_data = func_expr.bind_info->Cast<SparkCastDecimalBindData>();
+	auto &source = args.data[0];
+	if (!bind_data.ansi && source.GetVectorType() == VectorType::DICTIONARY_VECTOR) {
+		auto dictionary_size = DictionaryVector::DictionarySize(source);
+		if (dictionary_size.IsValid() && dictionary_size.GetIndex() < args.size()) {
+			Vector entry_result(result.GetType(), dictionary_size.GetIndex());
+			SparkCastDecimalVector<RESULT_TYPE>(DictionaryVector::Child(source), entry_result,
+			                                    dictionary_size.GetIndex(), bind_data);
+			result.Slice(entry_result, DictionaryVector::SelVector(source), args.size());
+			return;
+		}
+	}
+	SparkCastDecimalVector<RESULT_TYPE>(source, result, args.size(), bind_data);
+}
+
+static scalar_function_t GetSparkCastDecimalKernel(PhysicalType result_type) {
+	switch (result_type) {
+	case PhysicalType::INT16:
+		return SparkCastDecimalExec<int16_t>;
+	case PhysicalType::INT32:
+		return SparkCastDecimalExec<int32_t>;
+	case PhysicalType::INT64:
+		return SparkCastDecimalExec<int64_t>;
+	case PhysicalType::INT128:
+		return SparkCastDecimalExec<hugeint_t>;
+	default:
+		throw InternalException("Unexpected physical type for DECIMAL result");
+	}
+}
+
+// Constant INTEGER argument of spark_cast_decimal (precision or scale).
+static int64_t GetSparkCastTypeArgument(ClientContext &context, Expression &expr, const char *what) {
+	if (!expr.IsFoldable()) {
+		throw BinderException("spark_cast_decimal: %s must be a constant", what);
+	}
+	auto value = ExpressionExecutor::EvaluateScalar(context, expr);
+	if (value.IsNull()) {
+		throw BinderException("spark_cast_decimal: %s cannot be NULL", what);
+	}
+	return value.GetValue<int64_t>();
+}
+
+static unique_ptr<FunctionData> BindSparkCastDecimal(ClientContext &context, ScalarFunction &bound_function,
+                                                     vector<unique_ptr<Expression>> &arguments) {
+	// Spark's DECIMAL without parameters is DECIMAL(10, 0)
+	int64_t precision = 10;
+	int64_t scale = 0;
+	if (arguments.size() == 3) {
+		precision = GetSparkCastTypeArgument(context, *arguments[1], "precision");
+		scale = GetSparkCastTypeArgument(context, *arguments[2], "scale");
+		if (precision < 1 || precision > SPARK_MAX_PRECISION) {
+			throw BinderException("spark_cast_decimal: precision must be between 1 and %d, got %d",
+			                      static_cast<int64_t>(SPARK_MAX_PRECISION), precision);
+		}
+		if (scale < 0 || scale > precision) {
+			throw BinderException("spark_cast_decimal: scale must be between 0 and the precision %d, got %d",
+			                      precision, scale);
+		}
+		Function::EraseArgument(bound_function, arguments, 2);
+		Function::EraseArgument(bound_function, arguments, 1);
+	}
+
+	auto result_type = LogicalType::DECIMAL(static_cast<uint8_t>(precision), static_cast<uint8_t>(scale));
+	bound_function.return_type = result_type;
+	bound_function.function = GetSparkCastDecimalKernel(result_type.InternalType());
+	return make_uniq<SparkCastDecimalBindData>(static_cast<uint8_t>(precision), static_cast<uint8_t>(scale),
+	                                           SparkAnsiEnabled(context));
+}
+
+// ---------------------------------------------------------------------------
+// spark_decimal_to_string(decimal)
+// ---------------------------------------------------------------------------
+
+template <typename INPUT_TYPE>
+static void SparkDecimalToStringExec(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &input = args.data[0];
+	auto scale = DecimalType::GetScale(input.GetType());
+	UnaryExecutor::Execute<INPUT_TYPE, string_t>(input, result, args.size(), [&](const INPUT_TYPE &value) {
+		char buffer[SPARK_DECIMAL_STRING_SIZE];
+		auto length = SparkFormatDecimal(DecimalToInt128(value), scale, buffer);
+		return StringVector::AddString(result, buffer, length);
+	});
+}
+
+static unique_ptr<FunctionData> BindSparkDecimalToString(ClientContext &context, ScalarFunction &bound_function,
+                                                         vector<unique_ptr<Expression>> &arguments) {
+	auto &type = arguments[0]->return_type;
+	if (type.id() != LogicalTypeId::DECIMAL) {
+		throw InvalidInputException("spark_decimal_to_string requires DECIMAL argument, got %s", type.ToString());
+	}
+	bound_function.arguments[0] = type;
+	switch (type.InternalType()) {
+	case PhysicalType::INT16:
+		bound_function.function = SparkDecimalToStringExec<int16_t>;
+		break;
+	case PhysicalType::INT32:
+		bound_function.function = SparkDecimalToStringExec<int32_t>;
+		break;
+	case PhysicalType::INT64:
+		bound_function.function = SparkDecimalToStringExec<int64_t>;
+		break;
+	case PhysicalType::INT128:
+		bound_function.function = SparkDecimalToStringExec<hugeint_t>;
+		break;
+	default:
+		throw InternalException("Unexpected physical type for DECIMAL input");
+	}
+	return nullptr;
+}
+
+// ---------------------------------------------------------------------------
+// Registration
+// ---------------------------------------------------------------------------
+
+void RegisterSparkCastFunctions(ExtensionLoader &loader) {
+	ScalarFunctionSet cast_set("spark_cast_decimal");
+	cast_set.AddFunction(ScalarFunction({LogicalType::VARCHAR}, LogicalType::ANY, SparkCastDecimalExec<int64_t>,
+	                                    BindSparkCastDecimal));
+	cast_set.AddFunction(ScalarFunction({LogicalType::VARCHAR, LogicalType::INTEGER, LogicalType::INTEGER},
+	                                    LogicalType::ANY, SparkCastDecimalExec<hugeint_t>, BindSparkCastDecimal));
+	loader.RegisterFunction(cast_set);
+
+	loader.RegisterFunction(ScalarFunction("spark_decimal_to_string", {LogicalType::ANY}, LogicalType::VARCHAR,
+	                                       SparkDecimalToStringExec<hugeint_t>, BindSparkDecimalToString));
+}
+
+} // namespace duckdb
@@ -0,0 +1,169 @@
+#include "spark_counters.hpp"
+
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+
+#include <mutex>
+
+namespace duckdb {
+
+// ---------------------------------------------------------------------------
+// Counter block registry
+// ---------------------------------------------------------------------------
+
+struct SparkCounterInfo {
+	const char *name;
+	const char *description;
+};
+
+static const SparkCounterInfo SPARK_COUNTER_INFO[SPARK_COUNTER_COUNT] = {
+    {"div_rows", "rows evaluated by spark_decimal_div, the DECIMAL / operator, div/%/pmod and division comparisons"},
+    {"div_wide_rows", "dividends whose scaled value exceeded 128 bits (256-bit path)"},
+    {"div_zero_divisor_rows", "rows that returned NULL because the divisor was zero"},
+    {"div_constant_divisor_rows", "rows divided by a constant divisor through a precomputed reciprocal"},
+    {"div_overflow_rows", "rows that returned NULL because the quotient overflowed the result precision"},
+    {"div_dictionary_rows", "rows answered from dictionary entries that were each divided once"},
+    {"arith_rows", "rows evaluated by spark_decimal_mul/add/sub and the DECIMAL *, +, - operators"},
+    {"arith_overflow_rows", "rows that returned NULL because the result precision overflowed"},
+    {"agg_narrow_rows", "rows aggregated by the int64 spark_sum/spark_avg states"},
+    {"agg_wide_rows", "rows aggregated by the hugeint_t spark_sum/spark_avg states"},
+    {"agg_integer_rows", "rows aggregated by the TINYINT/SMALLINT/INTEGER/BIGINT spark_sum overloads"},
+};
+
+struct SparkCounterRegistry {
+	std::mutex lock;
+	vector<unique_ptr<SparkCounterBlock>> blocks;
+	vector<SparkCounterBlock *> free_blocks;
+
+	// Intentionally leaked: thread_local handles may release their block
+	// during process exit, after static destructors have run.
+	static SparkCounterRegistry &Get() {
+		static auto *registry = new SparkCounterRegistry();
+		return *registry;
+	}
+};
+
+SparkCounterBlock *AcquireSparkCounterBlock() {
+	auto &registry = SparkCounterRegistry::Get();
+	std::lock_guard<std::mutex> guard(registry.lock);
+	if (!registry.free_blocks.empty()) {
+		auto block = registry.free_blocks.back();
+		registry.free_blocks.pop_back();
+		return block;
+	}
+	auto block = make_uniq<SparkCounterBlock>();
+	for (auto &value : block->values) {
+		value.store(0, std::memory_order_relaxed);
+	}
+	registry.blocks.push_back(std::move(block));
+	return registry.blocks.back().get();
+}
+
+void ReleaseSparkCounterBlock(SparkCounterBlock *block) {
+	auto &registry = SparkCounterRegistry::Get();
+	std::lock_guard<std::mutex> guard(registry.lock);
+	registry.free_blocks.push_back(block);
+}
+
+static void SnapshotSparkCounters(uint64_t (&totals)[SPARK_COUNTER_COUNT]) {
+	auto &registry = SparkCounterRegistry::Get();
+	std::lock_guard<std::mutex> guard(registry.lock);
+	for (idx_t i = 0; i < SPARK_COUNTER_COUNT; i++) {
+		totals[i] = 0;
+	}
+	for (auto &block : registry.blocks) {
+		for (idx_t i = 0; i < SPARK_COUNTER_COUNT; i++) {
+			totals[i] += block->values[i].load(std::memory_order_relaxed);
+		}
+	}
+}
+
+static void ResetSparkCounters() {
+	auto &registry = SparkCounterRegistry::Get();
+	std::lock_guard<std::mutex> guard(registry.lock);
+	for (auto &block : registry.blocks) {
+		for (auto &value : block->values) {
+			value.store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------
+// thdck_spark_stats(): one row per counter
+// ---------------------------------------------------------------------------
+
+struct SparkStatsGlobalState : public GlobalTableFunctionState {
+	uint64_t totals[SPARK_COUNTER_COUNT];
+	idx_t offset = 0;
+};
+
+static unique_ptr<FunctionData> SparkStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                               vector<LogicalType> &return_types, vector<string> &names) {
+	names.emplace_back("name");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	names.emplace_back("value");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("description");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	return nullptr;
+}
+
+static unique_ptr<GlobalTableFunctionState> SparkStatsInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto state = make_uniq<SparkStatsGlobalState>();
+	SnapshotSparkCounters(state->totals);
+	return std::move(state);
+}
+
+static void SparkStatsFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<SparkStatsGlobalState>();
+	idx_t count = 0;
+	for (; state.offset < SPARK_COUNTER_COUNT && count < STANDARD_VECTOR_SIZE; state.offset++, count++) {
+		auto &info = SPARK_COUNTER_INFO[state.offset];
+		output.SetValue(0, count, Value(info.name));
+		output.SetValue(1, count, Value::UBIGINT(state.totals[state.offset]));
+		output.SetValue(2, count, Value(info.description));
+	}
+	output.SetCardinality(count);
+}
+
+// ---------------------------------------------------------------------------
+// thdck_spark_stats_reset(): zero every counter, returns a single row
+// ---------------------------------------------------------------------------
+
+struct SparkStatsResetGlobalState : public GlobalTableFunctionState {
+	bool finished = false;
+};
+
+static unique_ptr<FunctionData> SparkStatsResetBind(ClientContext &context, TableFunctionBindInput &input,
+                                                    vector<LogicalType> &return_types, vector<string> &names) {
+	names.emplace_back("success");
+	return_types.emplace_back(LogicalType::BOOLEAN);
+	return nullptr;
+}
+
+static unique_ptr<GlobalTableFunctionState> SparkStatsResetInit(ClientContext &context,
+                                                                TableFunctionInitInput &input) {
+	return make_uniq<SparkStatsResetGlobalState>();
+}
+
+static void SparkStatsResetFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<SparkStatsResetGlobalState>();
+	if (state.finished) {
+		return;
+	}
+	ResetSparkCounters();
+	state.finished = true;
+	output.SetValue(0, 0, Value::BOOLEAN(true));
+	output.SetCardinality(1);
+}
+
+void RegisterSparkCounterFunctions(ExtensionLoader &loader) {
+	TableFunction stats_func("thdck_spark_stats", {}, SparkStatsFunction, SparkStatsBind, SparkStatsInit);
+	loader.RegisterFunction(stats_func);
+
+	TableFunction reset_func("thdck_spark_stats_reset", {}, SparkStatsResetFunction, SparkStatsResetBind,
+	                         SparkStatsResetInit);
+	loader.RegisterFunction(reset_func);
+}
+
+} // namespace duckdb
@@ -0,0 +1,277 @@
+#include "spark_div_compare.hpp"
+#include "spark_counters.hpp"
+#include "spark_ansi.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/types/decimal.hpp"
+#include "duckdb/function/scalar_function.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+
+namespace duckdb {
+
+// ---------------------------------------------------------------------------
+// Per-row comparisons, from q >= c and q >= c + 1
+// ---------------------------------------------------------------------------
+// |c| < 10^38, so c + 1 stays within SparkQuotientAtLeast's range.
+
+struct SparkDivEqualsOp {
+	static constexpr const char *NAME = "spark_decimal_div_eq";
+	template <typename QUOTIENT>
+	static bool Operation(const QUOTIENT &q, __int128 c) {
+		return SparkQuotientAtLeast(q, c) && !SparkQuotientAtLeast(q, c + 1);
+	}
+};
+
+struct SparkDivNotEqualsOp {
+	static constexpr const char *NAME = "spark_decimal_div_ne";
+	template <typename QUOTIENT>
+	static bool Operation(const QUOTIENT &q, __int128 c) {
+		return !SparkQuotientAtLeast(q, c) || SparkQuotientAtLeast(q, c + 1);
+	}
+};
+
+struct SparkDivLessThanOp {
+	static constexpr const char *NAME = "spark_decimal_div_lt";
+	template <typename QUOTIENT>
+	static bool Operation(const QUOTIENT &q, __int128 c) {
+		return !SparkQuotientAtLeast(q, c);
+	}
+};
+
+struct SparkDivLessThanEqualsOp {
+	static constexpr const char *NAME = "spark_decimal_div_le";
+	template <typename QUOTIENT>
+	static bool Operation(const QUOTIENT &q, __int128 c) {
+		return !SparkQuotientAtLeast(q, c + 1);
+	}
+};
+
+struct SparkDivGreaterThanOp {
+	static constexpr const char *NAME = "spark_decimal_div_gt";
+	template <typename QUOTIENT>
+	static bool Operation(const QUOTIENT &q, __int128 c) {
+		return SparkQuotientAtLeast(q, c + 1);
+	}
+};
+
+struct SparkDivGreaterThanEqualsOp {
+	static constexpr const char *NAME = "spark_decimal_div_ge";
+	template <typename QUOTIENT>
+	static bool Operation(const QUOTIENT &q, __int128 c) {
+		return SparkQuotientAtLeast(q, c);
+	}
+};
+
+// SparkQuotientWide for any operands; SparkQuotientNarrow when the scaled
+// dividend fits in int64_t; SparkQuotientComputed when scale_adj > 38 (the
+// bind decides)
+template <typename QUOTIENT>
+static inline QUOTIENT SparkMakeQuotient(__int128 a, __int128 b, const SparkDivScale &scale);
+
+template <>
+inline SparkQuotientWide SparkMakeQuotient<SparkQuotientWide>(__int128 a, __int128 b, const SparkDivScale &scale) {
+	return SparkQuotientWide(a, b, scale.pow10_val != 0 ? scale.pow10_val : 1);
+}
+
+template <>
+inline SparkQuotientNarrow SparkMakeQuotient<SparkQuotientNarrow>(__int128 a, __int128 b, const SparkDivScale &scale) {
+	return SparkQuotientNarrow(static_cast<int64_t>(a), static_cast<int64_t>(b), scale.pow10_64);
+}
+
+template <>
+inline SparkQuotientComputed SparkMakeQuotient<SparkQuotientComputed>(__int128 a, __int128 b,
+                                                                      const SparkDivScale &scale) {
+	return SparkQuotientComputed(a, b, scale);
+}
+
+// ---------------------------------------------------------------------------
+// Execution
+// ---------------------------------------------------------------------------
+// The executor hands over only the rows that are still selected (a filter's
+// survivors, a CASE branch's rows), so every row here is one that the
+// division would have computed.
+
+template <typename A_TYPE, typename B_TYPE, typename QUOTIENT, typename OP>
+static void SparkDivCompareExec(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &bind_data = func_expr.bind_info->Cast<SparkDivCompareBindData>();
+	idx_t count = args.size();
+	SparkCountAdd(SparkCounter::DIV_ROWS, count);
+
+	bool all_constant = true;
+	for (auto &column : args.data) {
+		all_constant = all_constant && column.GetVectorType() == VectorType::CONSTANT_VECTOR;
+	}
+	idx_t rows = all_constant ? 1 : count;
+	result.SetVectorType(all_constant ? VectorType::CONSTANT_VECTOR : VectorType::FLAT_VECTOR);
+	auto *result_data = all_constant ? ConstantVector::GetData<bool>(result) : FlatVector::GetData<bool>(result);
+	auto &result_validity = all_constant ? ConstantVector::Validity(result) : FlatVector::Validity(result);
+
+	UnifiedVectorFormat a_fmt, b_fmt, c_fmt;
+	args.data[0].ToUnifiedFormat(rows, a_fmt);
+	args.data[1].ToUnifiedFormat(rows, b_fmt);
+	args.data[2].ToUnifiedFormat(rows, c_fmt);
+	const auto *a_data = UnifiedVectorFormat::GetData<A_TYPE>(a_fmt);
+	const auto *b_data = UnifiedVectorFormat::GetData<B_TYPE>(b_fmt);
+	const auto *c_data = UnifiedVectorFormat::GetData<hugeint_t>(c_fmt);
+
+	SparkDivScale scale(bind_data.scale_adj);
+	unsigned __int128 limit = Pow10_128(bind_data.result.precision);
+	idx_t zero_count = 0;
+	idx_t overflow_count = 0;
+	for (idx_t i = 0; i < rows; i++) {
+		auto a_idx = a_fmt.sel->get_index(i);
+		auto b_idx = b_fmt.sel->get_index(i);
+		auto c_idx = c_fmt.sel->get_index(i);
+		if (!a_fmt.validity.RowIsValid(a_idx) || !b_fmt.validity.RowIsValid(b_idx)) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		__int128 b_val = DecimalToInt128(b_data[b_idx]);
+		if (b_val == 0) {
+			zero_count++;
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		auto q = SparkMakeQuotient<QUOTIENT>(DecimalToInt128(a_data[a_idx]), b_val, scale);
+		// A quotient past the result precision is NULL, or an error, before c is looked at
+		if (bind_data.check_range && SparkQuotientMagnitudeAtLeast(q, limit)) {
+			if (bind_data.ansi) {
+				ThrowSparkDecimalOverflow(LogicalType::DECIMAL(bind_data.result.precision, bind_data.result.scale));
+			}
+			overflow_count++;
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		if (!c_fmt.validity.RowIsValid(c_idx)) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		result_data[i] = OP::Operation(q, HugeintToInt128(c_data[c_idx]));
+	}
+	// A constant row stands for every row, as in the division kernels
+	SparkCountAdd(SparkCounter::DIV_ZERO_DIVISOR_ROWS, all_constant ? zero_count * count : zero_count);
+	SparkCountAdd(SparkCounter::DIV_OVERFLOW_ROWS, all_constant ? overflow_count * count : overflow_count);
+}
+
+// ---------------------------------------------------------------------------
+// Kernel selection: one instantiation per (input, input) physical type
+// ---------------------------------------------------------------------------
+
+template <typename A_TYPE, typename QUOTIENT, typename OP>
+static scalar_function_t GetSparkDivCompareKernel(PhysicalType b_type) {
+	switch (b_type) {
+	case PhysicalType::INT16:
+		return SparkDivCompareExec<A_TYPE, int16_t, QUOTIENT, OP>;
+	case PhysicalType::INT32:
+		return SparkDivCompareExec<A_TYPE, int32_t, QUOTIENT, OP>;
+	case PhysicalType::INT64:
+		return SparkDivCompareExec<A_TYPE, int64_t, QUOTIENT, OP>;
+	case PhysicalType::INT128:
+		return SparkDivCompareExec<A_TYPE, hugeint_t, QUOTIENT, OP>;
+	default:
+		throw InternalException("Unexpected physical type for DECIMAL divisor");
+	}
+}
+
+template <typename QUOTIENT, typename OP>
+static scalar_function_t GetSparkDivCompareKernel(PhysicalType a_type, PhysicalType b_type) {
+	switch (a_type) {
+	case PhysicalType::INT16:
+		return GetSparkDivCompareKernel<int16_t, QUOTIENT, OP>(b_type);
+	case PhysicalType::INT32:
+		return GetSparkDivCompareKernel<int32_t, QUOTIENT, OP>(b_type);
+	case PhysicalType::INT64:
+		return GetSparkDivCompareKernel<int64_t, QUOTIENT, OP>(b_type);
+	case PhysicalType::INT128:
+		return GetSparkDivCompareKernel<hugeint_t, QUOTIENT, OP>(b_type);
+	default:
+		throw InternalException("Unexpected physical type for DECIMAL dividend");
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Bind function: resolve types and select implementation
+// ---------------------------------------------------------------------------
+
+template <typename OP>
+static unique_ptr<FunctionData> BindSparkDivCompare(ClientContext &context, ScalarFunction &bound_function,
+                                                    vector<unique_ptr<Expression>> &arguments) {
+	auto &type_a = arguments[0]->return_type;
+	auto &type_b = arguments[1]->return_type;
+	if (type_a.id() != LogicalTypeId::DECIMAL || type_b.id() != LogicalTypeId::DECIMAL) {
+		throw InvalidInputException("%s requires DECIMAL arguments", OP::NAME);
+	}
+
+	uint8_t p1 = DecimalType::GetWidth(type_a);
+	uint8_t s1 = DecimalType::GetScale(type_a);
+	uint8_t p2 = DecimalType::GetWidth(type_b);
+	uint8_t s2 = DecimalType::GetScale(type_b);
+
+	// The quotient type and scaling of spark_decimal_div
+	auto result = ComputeDivisionType(p1, s1, p2, s2);
+	uint32_t scale_adj = static_cast<uint32_t>(result.scale) - static_cast<uint32_t>(s1) + static_cast<uint32_t>(s2);
+
+	// Inputs keep their declared types; c is compared at the quotient's scale
+	bound_function.arguments[0] = type_a;
+	bound_function.arguments[1] = type_b;
+	bound_function.arguments[2] = LogicalType::DECIMAL(SPARK_MAX_PRECISION, result.scale);
+
+	// |a| < 10^p1, so 2 |a| 10^scale_adj < 2^64 whenever p1 + scale_adj <= 18
+	auto a_type = type_a.InternalType();
+	auto b_type = type_b.InternalType();
+	if (a_type != PhysicalType::INT128 && b_type != PhysicalType::INT128 && p1 + scale_adj <= 18) {
+		bound_function.function = GetSparkDivCompareKernel<SparkQuotientNarrow, OP>(a_type, b_type);
+	} else if (scale_adj > 38) {
+		bound_function.function = GetSparkDivCompareKernel<SparkQuotientComputed, OP>(a_type, b_type);
+	} else {
+		bound_function.function = GetSparkDivCompareKernel<SparkQuotientWide, OP>(a_type, b_type);
+	}
+
+	return make_uniq<SparkDivCompareBindData>(scale_adj, result, p1 + scale_adj > result.precision,
+	                                          SparkAnsiEnabled(context));
+}
+
+// ---------------------------------------------------------------------------
+// Registration
+// ---------------------------------------------------------------------------
+
+template <typename OP>
+static ScalarFunction GetSparkDivCompareFunction() {
+	ScalarFunction func(OP::NAME, {LogicalType::ANY, LogicalType::ANY, LogicalType::ANY}, LogicalType::BOOLEAN,
+	                    SparkDivCompareExec<hugeint_t, hugeint_t, SparkQuotientWide, OP>, BindSparkDivCompare<OP>);
+	// NULL inputs are handled per row: an overflowing quotient raises in ANSI mode even when c is NULL
+	func.null_handling = FunctionNullHandling::SPECIAL_HANDLING;
+	return func;
+}
+
+ScalarFunction GetSparkDivCompareFunction(ExpressionType comparison) {
+	switch (comparison) {
+	case ExpressionType::COMPARE_EQUAL:
+		return GetSparkDivCompareFunction<SparkDivEqualsOp>();
+	case ExpressionType::COMPARE_NOTEQUAL:
+		return GetSparkDivCompareFunction<SparkDivNotEqualsOp>();
+	case ExpressionType::COMPARE_LESSTHAN:
+		return GetSparkDivCompareFunction<SparkDivLessThanOp>();
+	case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+		return GetSparkDivCompareFunction<SparkDivLessThanEqualsOp>();
+	case ExpressionType::COMPARE_GREATERTHAN:
+		return GetSparkDivCompareFunction<SparkDivGreaterThanOp>();
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+		return GetSparkDivCompareFunction<SparkDivGreaterThanEqualsOp>();
+	default:
+		throw InternalException("Unexpected comparison for spark_decimal_div");
+	}
+}
+
+void RegisterSparkDivCompareFunctions(ExtensionLoader &loader) {
+	loader.RegisterFunction(GetSparkDivCompareFunction<SparkDivEqualsOp>());
+	loader.RegisterFunction(GetSparkDivCompareFunction<SparkDivNotEqualsOp>());
+	loader.RegisterFunction(GetSparkDivCompareFunction<SparkDivLessThanOp>());
+	loader.RegisterFunction(GetSparkDivCompareFunction<SparkDivLessThanEqualsOp>());
+	loader.RegisterFunction(GetSparkDivCompareFunction<SparkDivGreaterThanOp>());
+	loader.RegisterFunction(GetSparkDivCompareFunction<SparkDivGreaterThanEqualsOp>());
+}
+
+} // namespace duckdb
@@ -0,0 +1,196 @@
+#include "spark_divmod.hpp"
+#include "spark_counters.hpp"
+#include "spark_ansi.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/types/decimal.hpp"
+#include "duckdb/common/vector_operations/binary_executor.hpp"
+#include "duckdb/function/scalar_function.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+
+namespace duckdb {
+
+// ---------------------------------------------------------------------------
+// Per-row operators
+// ---------------------------------------------------------------------------
+
+struct SparkIntDivOp {
+	static constexpr const char *NAME = "spark_decimal_intdiv";
+
+	// Spark's IntegralDivide always returns LongType
+	static LogicalType ResultType(uint8_t, uint8_t, uint8_t, uint8_t) {
+		return LogicalType::BIGINT;
+	}
+	static SparkDivModParams Params(uint8_t s1, uint8_t s2, const LogicalType &) {
+		return MakeSparkDivModParams(s1, s2, static_cast<unsigned __int128>(1) << 63);
+	}
+	static bool Operation(__int128 a, __int128 b, const SparkDivModParams &params, __int128 &result) {
+		return SparkDecimalIntegralDivide(a, b, params, result);
+	}
+};
+
+struct SparkModOp {
+	static constexpr const char *NAME = "spark_decimal_mod";
+
+	static LogicalType ResultType(uint8_t p1, uint8_t s1, uint8_t p2, uint8_t s2) {
+		auto result = ComputeRemainderType(p1, s1, p2, s2);
+		return LogicalType::DECIMAL(result.precision, result.scale);
+	}
+	static SparkDivModParams Params(uint8_t s1, uint8_t s2, const LogicalType &result_type) {
+		return MakeSparkDivModParams(s1, s2, Pow10_128(DecimalType::GetWidth(result_type)));
+	}
+	static bool Operation(__int128 a, __int128 b, const SparkDivModParams &params, __int128 &result) {
+		return SparkDecimalRemainder(a, b, params, result);
+	}
+};
+
+struct SparkPmodOp {
+	static constexpr const char *NAME = "spark_decimal_pmod";
+
+	static LogicalType ResultType(uint8_t p1, uint8_t s1, uint8_t p2, uint8_t s2) {
+		return SparkModOp::ResultType(p1, s1, p2, s2);
+	}
+	static SparkDivModParams Params(uint8_t s1, uint8_t s2, const LogicalType &result_type) {
+		return SparkModOp::Params(s1, s2, result_type);
+	}
+	static bool Operation(__int128 a, __int128 b, const SparkDivModParams &params, __int128 &result) {
+		return SparkDecimalPmod(a, b, params, result);
+	}
+};
+
+// ---------------------------------------------------------------------------
+// Execution: a zero divisor or an overflowing result makes the row NULL
+// ---------------------------------------------------------------------------
+// Division by zero is NULL in every mode, as for spark_decimal_div; overflow
+// raises once per vector in ANSI mode.
+
+template <typename A_TYPE, typename B_TYPE, typename RESULT_TYPE, typename OP>
+static void SparkDivModExec(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &bind_data = func_expr.bind_info->Cast<SparkDivModBindData>();
+	auto &params = bind_data.params;
+	idx_t count = args.size();
+	SparkCountAdd(SparkCounter::DIV_ROWS, count);
+
+	idx_t zero_count = 0;
+	idx_t overflow_count = 0;
+	BinaryExecutor::ExecuteWithNulls<A_TYPE, B_TYPE, RESULT_TYPE>(
+	    args.data[0], args.data[1], result, count, [&](A_TYPE a, B_TYPE b, ValidityMask &mask, idx_t idx) {
+		    __int128 b_val = DecimalToInt128(b);
+		    __int128 value = 0;
+		    if (b_val == 0) {
+			    zero_count++;
+			    mask.SetInvalid(idx);
+		    } else if (!OP::Operation(DecimalToInt128(a), b_val, params, value)) {
+			    overflow_count++;
+			    mask.SetInvalid(idx);
+		    }
+		    return Int128ToDecimal<RESULT_TYPE>(value);
+	    });
+	if (overflow_count > 0 && bind_data.ansi) {
+		ThrowSparkDecimalOverflow(result.GetType());
+	}
+	SparkCountAdd(SparkCounter::DIV_ZERO_DIVISOR_ROWS, zero_count);
+	SparkCountAdd(SparkCounter::DIV_OVERFLOW_ROWS, overflow_count);
+}
+
+// ---------------------------------------------------------------------------
+// Kernel selection: one instantiation per (input, input, result) physical type
+// ---------------------------------------------------------------------------
+
+template <typename A_TYPE, typename B_TYPE, typename OP>
+static scalar_function_t GetSparkDivModKernel(PhysicalType result_type) {
+	switch (result_type) {
+	case PhysicalType::INT16:
+		return SparkDivModExec<A_TYPE, B_TYPE, int16_t, OP>;
+	case PhysicalType::INT32:
+		return SparkDivModExec<A_TYPE, B_TYPE, int32_t, OP>;
+	case PhysicalType::INT64:
+		return SparkDivModExec<A_TYPE, B_TYPE, int64_t, OP>;
+	case PhysicalType::INT128:
+		return SparkDivModExec<A_TYPE, B_TYPE, hugeint_t, OP>;
+	default:
+		throw InternalException("Unexpected physical type for DECIMAL result");
+	}
+}
+
+template <typename A_TYPE, typename OP>
+static scalar_function_t GetSparkDivModKernel(PhysicalType b_type, PhysicalType result_type) {
+	switch (b_type) {
+	case PhysicalType::INT16:
+		return GetSparkDivModKernel<A_TYPE, int16_t, OP>(result_type);
+	case PhysicalType::INT32:
+		return GetSparkDivModKernel<A_TYPE, int32_t, OP>(result_type);
+	case PhysicalType::INT64:
+		return GetSparkDivModKernel<A_TYPE, int64_t, OP>(result_type);
+	case PhysicalType::INT128:
+		return GetSparkDivModKernel<A_TYPE, hugeint_t, OP>(result_type);
+	default:
+		throw InternalException("Unexpected physical type for DECIMAL operand");
+	}
+}
+
+template <typename OP>
+static scalar_function_t GetSparkDivModKernel(PhysicalType a_type, PhysicalType b_type, PhysicalType result_type) {
+	switch (a_type) {
+	case PhysicalType::INT16:
+		return GetSparkDivModKernel<int16_t, OP>(b_type, result_type);
+	case PhysicalType::INT32:
+		return GetSparkDivModKernel<int32_t, OP>(b_type, result_type);
+	case PhysicalType::INT64:
+		return GetSparkDivModKernel<int64_t, OP>(b_type, result_type);
+	case PhysicalType::INT128:
+		return GetSparkDivModKernel<hugeint_t, OP>(b_type, result_type);
+	default:
+		throw InternalException("Unexpected physical type for DECIMAL operand");
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Bind function: resolve types and select implementation
+// ---------------------------------------------------------------------------
+
+template <typename OP>
+static unique_ptr<FunctionData> BindSparkDecimalDivMod(ClientContext &context, ScalarFunction &bound_function,
+                                                       vector<unique_ptr<Expression>> &arguments) {
+	auto &type_a = arguments[0]->return_type;
+	auto &type_b = arguments[1]->return_type;
+	if (type_a.id() != LogicalTypeId::DECIMAL || type_b.id() != LogicalTypeId::DECIMAL) {
+		throw InvalidInputException("%s requires DECIMAL arguments", OP::NAME);
+	}
+	bound_function.arguments[0] = type_a;
+	bound_function.arguments[1] = type_b;
+
+	uint8_t p1 = DecimalType::GetWidth(type_a);
+	uint8_t s1 = DecimalType::GetScale(type_a);
+	uint8_t p2 = DecimalType::GetWidth(type_b);
+	uint8_t s2 = DecimalType::GetScale(type_b);
+
+	auto result_type = OP::ResultType(p1, s1, p2, s2);
+	bound_function.return_type = result_type;
+	bound_function.function =
+	    GetSparkDivModKernel<OP>(type_a.InternalType(), type_b.InternalType(), result_type.InternalType());
+
+	return make_uniq<SparkDivModBindData>(OP::Params(s1, s2, result_type), SparkAnsiEnabled(context));
+}
+
+// ---------------------------------------------------------------------------
+// Registration
+// ---------------------------------------------------------------------------
+
+template <typename OP>
+static ScalarFunction GetSparkDivModFunction() {
+	ScalarFunction func(OP::NAME, {LogicalType::ANY, LogicalType::ANY}, LogicalType::ANY,
+	                    SparkDivModExec<hugeint_t, hugeint_t, hugeint_t, OP>, BindSparkDecimalDivMod<OP>);
+	func.null_handling = FunctionNullHandling::SPECIAL_HANDLING;
+	return func;
+}
+
+void RegisterSparkDivModFunctions(ExtensionLoader &loader) {
+	loader.RegisterFunction(GetSparkDivModFunction<SparkIntDivOp>());
+	loader.RegisterFunction(GetSparkDivModFunction<SparkModOp>());
+	loader.RegisterFunction(GetSparkDivModFunction<SparkPmodOp>());
+}
+
+} // namespace duckdb
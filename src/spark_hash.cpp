@@ -0,0 +1,252 @@
+#include "spark_hash.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/function/scalar_function.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace duckdb {
+
+// ---------------------------------------------------------------------------
+// Functions
+// ---------------------------------------------------------------------------
+// spark_hash(a, b, ...) is Spark's hash(): Murmur3_x86_32, INTEGER result.
+// spark_xxhash64(a, b, ...) is Spark's xxhash64(): XXH64, BIGINT result.
+// Both start from seed 42 and hash the arguments left to right, each hash
+// seeding the next argument; a NULL argument leaves the hash unchanged, so
+// the result is never NULL.
+
+static constexpr int32_t SPARK_HASH_SEED = 42;
+
+struct SparkHashOp {
+	static constexpr const char *NAME = "spark_hash";
+	typedef SparkMurmur3 HASHER;
+	static LogicalType ResultType() {
+		return LogicalType::INTEGER;
+	}
+};
+
+struct SparkXxHash64Op {
+	static constexpr const char *NAME = "spark_xxhash64";
+	typedef SparkXxHash64 HASHER;
+	static LogicalType ResultType() {
+		return LogicalType::BIGINT;
+	}
+};
+
+// ---------------------------------------------------------------------------
+// Values: how Spark's HashExpression feeds each type to the hasher
+// ---------------------------------------------------------------------------
+
+// BOOLEAN (as 1 / 0), TINYINT, SMALLINT, INTEGER, DATE
+struct SparkHashIntValue {
+	template <typename HASHER, typename T>
+	static inline typename HASHER::hash_t Hash(const T &value, typename HASHER::hash_t seed) {
+		return HASHER::HashInt(static_cast<int32_t>(value), seed);
+	}
+};
+
+// BIGINT, TIMESTAMP (microseconds) and the unscaled DECIMAL(p <= 18)
+struct SparkHashLongValue {
+	template <typename HASHER, typename T>
+	static inline typename HASHER::hash_t Hash(const T &value, typename HASHER::hash_t seed) {
+		return HASHER::HashLong(static_cast<int64_t>(value), seed);
+	}
+};
+
+// The unscaled DECIMAL(p > 18), as BigInteger#toByteArray
+struct SparkHashBigIntegerValue {
+	template <typename HASHER, typename T>
+	static inline typename HASHER::hash_t Hash(const T &value, typename HASHER::hash_t seed) {
+		return HASHER::HashBigInteger(HugeintToInt128(value), seed);
+	}
+};
+
+// Float.floatToIntBits with -0.0 hashed as 0.0; NaN has one canonical encoding
+struct SparkHashFloatValue {
+	template <typename HASHER, typename T>
+	static inline typename HASHER::hash_t Hash(const T &value, typename HASHER::hash_t seed) {
+		int32_t bits = 0;
+		if (std::isnan(value)) {
+			bits = 0x7FC00000;
+		} else if (value != 0) {
+			memcpy(&bits, &value, sizeof(bits));
+		}
+		return HASHER::HashInt(bits, seed);
+	}
+};
+
+// Double.doubleToLongBits with -0.0 hashed as 0.0; NaN has one canonical encoding
+struct SparkHashDoubleValue {
+	template <typename HASHER, typename T>
+	static inline typename HASHER::hash_t Hash(const T &value, typename HASHER::hash_t seed) {
+		int64_t bits = 0;
+		if (std::isnan(value)) {
+			bits = 0x7FF8000000000000LL;
+		} else if (value != 0) {
+			memcpy(&bits, &value, sizeof(bits));
+		}
+		return HASHER::HashLong(bits, seed);
+	}
+};
+
+// VARCHAR (UTF-8 bytes) and BLOB
+struct SparkHashBytesValue {
+	template <typename HASHER, typename T>
+	static inline typename HASHER::hash_t Hash(const T &value, typename HASHER::hash_t seed) {
+		return HASHER::Hash(reinterpret_cast<const uint8_t *>(value.GetData()), value.GetSize(), seed);
+	}
+};
+
+// ---------------------------------------------------------------------------
+// Execution: column at a time, carrying each row's hash into the next column
+// ---------------------------------------------------------------------------
+
+template <typename HASHER, typename T, typename VALUE>
+static void SparkHashColumn(Vector &input, idx_t count, typename HASHER::hash_t *hashes) {
+	if (input.GetVectorType() == VectorType::FLAT_VECTOR && FlatVector::Validity(input).AllValid()) {
+		auto data = FlatVector::GetData<T>(input);
+		for (idx_t i = 0; i < count; i++) {
+			hashes[i] = VALUE::template Hash<HASHER>(data[i], hashes[i]);
+		}
+		return;
+	}
+	UnifiedVectorFormat format;
+	input.ToUnifiedFormat(count, format);
+	auto data = UnifiedVectorFormat::GetData<T>(format);
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = format.sel->get_index(i);
+		if (format.validity.RowIsValid(idx)) {
+			hashes[i] = VALUE::template Hash<HASHER>(data[idx], hashes[i]);
+		}
+	}
+}
+
+// A NULL literal hashes to the seed
+template <typename HASHER>
+static void SparkHashNullColumn(Vector &input, idx_t count, typename HASHER::hash_t *hashes) {
+}
+
+template <typename HASHER>
+static void SparkHashExec(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &bind_data = func_expr.bind_info->Cast<SparkHashBindData<HASHER>>();
+	typedef typename HASHER::hash_t hash_t;
+
+	bool all_constant = true;
+	for (auto &column : args.data) {
+		all_constant = all_constant && column.GetVectorType() == VectorType::CONSTANT_VECTOR;
+	}
+	idx_t count = all_constant ? 1 : args.size();
+	hash_t *hashes;
+	if (all_constant) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+		hashes = ConstantVector::GetData<hash_t>(result);
+	} else {
+		result.SetVectorType(VectorType::FLAT_VECTOR);
+		hashes = FlatVector::GetData<hash_t>(result);
+	}
+	std::fill(hashes, hashes + count, static_cast<hash_t>(SPARK_HASH_SEED));
+	for (idx_t col = 0; col < args.ColumnCount(); col++) {
+		bind_data.columns[col](args.data[col], count, hashes);
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Kernel selection: one instantiation per argument type and physical width
+// ---------------------------------------------------------------------------
+
+template <typename HASHER>
+static typename SparkHashBindData<HASHER>::column_function_t GetSparkHashColumn(const LogicalType &type,
+                                                                                 const char *name) {
+	switch (type.id()) {
+	case LogicalTypeId::SQLNULL:
+		return SparkHashNullColumn<HASHER>;
+	case LogicalTypeId::BOOLEAN:
+		return SparkHashColumn<HASHER, bool, SparkHashIntValue>;
+	case LogicalTypeId::TINYINT:
+		return SparkHashColumn<HASHER, int8_t, SparkHashIntValue>;
+	case LogicalTypeId::SMALLINT:
+		return SparkHashColumn<HASHER, int16_t, SparkHashIntValue>;
+	case LogicalTypeId::INTEGER:
+		return SparkHashColumn<HASHER, int32_t, SparkHashIntValue>;
+	case LogicalTypeId::DATE:
+		return SparkHashColumn<HASHER, date_t, SparkHashIntValue>;
+	case LogicalTypeId::BIGINT:
+		return SparkHashColumn<HASHER, int64_t, SparkHashLongValue>;
+	case LogicalTypeId::TIMESTAMP:
+	case LogicalTypeId::TIMESTAMP_TZ:
+		return SparkHashColumn<HASHER, timestamp_t, SparkHashLongValue>;
+	case LogicalTypeId::FLOAT:
+		return SparkHashColumn<HASHER, float, SparkHashFloatValue>;
+	case LogicalTypeId::DOUBLE:
+		return SparkHashColumn<HASHER, double, SparkHashDoubleValue>;
+	case LogicalTypeId::VARCHAR:
+	case LogicalTypeId::BLOB:
+		return SparkHashColumn<HASHER, string_t, SparkHashBytesValue>;
+	case LogicalTypeId::DECIMAL:
+		switch (type.InternalType()) {
+		case PhysicalType::INT16:
+			return SparkHashColumn<HASHER, int16_t, SparkHashLongValue>;
+		case PhysicalType::INT32:
+			return SparkHashColumn<HASHER, int32_t, SparkHashLongValue>;
+		case PhysicalType::INT64:
+			return SparkHashColumn<HASHER, int64_t, SparkHashLongValue>;
+		case PhysicalType::INT128:
+			return SparkHashColumn<HASHER, hugeint_t, SparkHashBigIntegerValue>;
+		default:
+			throw InternalException("Unexpected physical type for DECIMAL input");
+		}
+	default:
+		throw InvalidInputException("%s does not support arguments of type %s", name, type.ToString());
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Bind function: fix each argument's type and select its kernel
+// ---------------------------------------------------------------------------
+
+template <typename OP>
+static unique_ptr<FunctionData> BindSparkHash(ClientContext &context, ScalarFunction &bound_function,
+                                              vector<unique_ptr<Expression>> &arguments) {
+	typedef typename OP::HASHER HASHER;
+	if (arguments.empty()) {
+		throw InvalidInputException("%s requires at least one argument", OP::NAME);
+	}
+	vector<typename SparkHashBindData<HASHER>::column_function_t> columns;
+	bound_function.arguments.clear();
+	for (auto &argument : arguments) {
+		// Literals take the type Spark gives them: INT / BIGINT and STRING
+		auto type = argument->return_type;
+		if (type.id() == LogicalTypeId::INTEGER_LITERAL) {
+			type = IntegerLiteral::GetType(type);
+		} else if (type.id() == LogicalTypeId::STRING_LITERAL) {
+			type = LogicalType::VARCHAR;
+		}
+		columns.push_back(GetSparkHashColumn<HASHER>(type, OP::NAME));
+		bound_function.arguments.push_back(type);
+	}
+	return make_uniq<SparkHashBindData<HASHER>>(std::move(columns));
+}
+
+// ---------------------------------------------------------------------------
+// Registration
+// ---------------------------------------------------------------------------
+
+template <typename OP>
+static ScalarFunction GetSparkHashFunction() {
+	ScalarFunction func(OP::NAME, {}, OP::ResultType(), SparkHashExec<typename OP::HASHER>, BindSparkHash<OP>);
+	func.varargs = LogicalType::ANY;
+	func.null_handling = FunctionNullHandling::SPECIAL_HANDLING;
+	return func;
+}
+
+void RegisterSparkHashFunctions(ExtensionLoader &loader) {
+	loader.RegisterFunction(GetSparkHashFunction<SparkHashOp>());
+	loader.RegisterFunction(GetSparkHashFunction<SparkXxHash64Op>());
+}
+
+} // namespace duckdb
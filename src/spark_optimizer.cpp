@@ -0,0 +1,564 @@
+#include "spark_optimizer.hpp"
+#include "spark_div_compare.hpp"
+#include "spark_sum_count.hpp"
+#include "spark_sum_ratio.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/function/function_binder.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/optimizer/column_binding_replacer.hpp"
+#include "duckdb/optimizer/optimizer.hpp"
+#include "duckdb/optimizer/optimizer_extension.hpp"
+#include "duckdb/planner/binder.hpp"
+#include "duckdb/planner/expression/bound_aggregate_expression.hpp"
+#include "duckdb/planner/expression/bound_cast_expression.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_comparison_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/expression_iterator.hpp"
+#include "duckdb/planner/logical_operator_visitor.hpp"
+#include "duckdb/planner/operator/logical_aggregate.hpp"
+#include "duckdb/planner/operator/logical_projection.hpp"
+
+#include <functional>
+
+namespace duckdb {
+
+static bool SparkRewriteEnabled(ClientContext &context, const char *setting) {
+	Value value;
+	if (!context.TryGetCurrentSetting(setting, value) || value.IsNull()) {
+		return true;
+	}
+	return BooleanValue::Get(value);
+}
+
+// The DECIMAL `/` or spark_decimal_div with Spark's result type. Any other
+// DECIMAL division (another `/` overload) is left alone.
+static bool IsSparkDecimalDivision(const BoundFunctionExpression &func) {
+	if ((func.function.name != "/" && func.function.name != "spark_decimal_div") || func.children.size() != 2) {
+		return false;
+	}
+	auto &type_a = func.children[0]->return_type;
+	auto &type_b = func.children[1]->return_type;
+	if (type_a.id() != LogicalTypeId::DECIMAL || type_b.id() != LogicalTypeId::DECIMAL) {
+		return false;
+	}
+	auto result = ComputeDivisionType(DecimalType::GetWidth(type_a), DecimalType::GetScale(type_a),
+	                                  DecimalType::GetWidth(type_b), DecimalType::GetScale(type_b));
+	return func.return_type == LogicalType::DECIMAL(result.precision, result.scale);
+}
+
+// ---------------------------------------------------------------------------
+// Constant divisors
+// ---------------------------------------------------------------------------
+// BindSparkDecimalDiv only specializes on a divisor that is a constant
+// expression. Operands that merely fold (arithmetic or casts on constants) are
+// evaluated here and the division is bound again with the constants. Runs
+// first, so the other rules and DuckDB's optimizers see the folded division.
+
+class SparkConstantDivisorRewriter : public LogicalOperatorVisitor {
+public:
+	explicit SparkConstantDivisorRewriter(ClientContext &context_p) : context(context_p), function_binder(context_p) {
+	}
+
+	unique_ptr<Expression> VisitReplace(BoundFunctionExpression &expr, unique_ptr<Expression> *expr_ptr) override {
+		if (!IsSparkDecimalDivision(expr)) {
+			return nullptr;
+		}
+		bool folded = false;
+		for (auto &child : expr.children) {
+			Value value;
+			if (child->GetExpressionClass() == ExpressionClass::BOUND_CONSTANT || !child->IsFoldable() ||
+			    !ExpressionExecutor::TryEvaluateScalar(context, *child, value)) {
+				continue;
+			}
+			child = make_uniq<BoundConstantExpression>(std::move(value));
+			folded = true;
+		}
+		if (!folded) {
+			return nullptr;
+		}
+		auto result = function_binder.BindScalarFunction(expr.function, std::move(expr.children), expr.is_operator);
+		result->alias = expr.alias;
+		VisitExpressionChildren(*result);
+		return result;
+	}
+
+private:
+	ClientContext &context;
+	FunctionBinder function_binder;
+};
+
+// ---------------------------------------------------------------------------
+// Shared sum + count
+// ---------------------------------------------------------------------------
+// Runs before DuckDB's own optimizers, so the new projection is pushed
+// through and pruned like any other, and statistics propagation narrows the
+// spark_sum_count state exactly as it would narrow spark_sum / spark_avg.
+
+enum class SparkSharedAggregate : uint8_t { SUM, AVG, COUNT };
+
+static const char *SparkSharedAggregateField(SparkSharedAggregate kind) {
+	switch (kind) {
+	case SparkSharedAggregate::SUM:
+		return "sum";
+	case SparkSharedAggregate::AVG:
+		return "avg";
+	default:
+		return "count";
+	}
+}
+
+// spark_sum / spark_avg / count over one DECIMAL argument, without modifiers
+static bool GetSparkSharedAggregate(const BoundAggregateExpression &aggr, SparkSharedAggregate &kind) {
+	if (aggr.IsDistinct() || aggr.filter || aggr.order_bys || aggr.children.size() != 1 ||
+	    aggr.children[0]->return_type.id() != LogicalTypeId::DECIMAL || aggr.children[0]->IsVolatile()) {
+		return false;
+	}
+	auto &name = aggr.function.name;
+	if (name == "spark_sum") {
+		kind = SparkSharedAggregate::SUM;
+	} else if (name == "spark_avg") {
+		kind = SparkSharedAggregate::AVG;
+	} else if (name == "count") {
+		kind = SparkSharedAggregate::COUNT;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+struct SparkSharedAggregateGroup {
+	vector<idx_t> members; // positions in LogicalAggregate::expressions
+	bool has_sum_or_avg = false;
+	unique_ptr<Expression> shared;                  // the bound spark_sum_count
+	idx_t shared_index = DConstants::INVALID_INDEX; // position of spark_sum_count in the rewritten list
+};
+
+// True when the spark_sum_count field for `kind` has the type the original
+// aggregate returned
+static bool SparkSharedFieldMatches(const LogicalType &shared_type, SparkSharedAggregate kind,
+                                    const LogicalType &expected) {
+	for (auto &field : StructType::GetChildTypes(shared_type)) {
+		if (field.first == SparkSharedAggregateField(kind)) {
+			return field.second == expected;
+		}
+	}
+	return false;
+}
+
+static unique_ptr<Expression> BindSparkSharedField(ClientContext &context, LogicalAggregate &aggr, idx_t shared_index,
+                                                   SparkSharedAggregate kind) {
+	auto &shared = *aggr.expressions[shared_index];
+	vector<unique_ptr<Expression>> children;
+	children.push_back(make_uniq<BoundColumnRefExpression>(shared.return_type,
+	                                                       ColumnBinding(aggr.aggregate_index, shared_index)));
+	children.push_back(make_uniq<BoundConstantExpression>(Value(SparkSharedAggregateField(kind))));
+	ErrorData error;
+	FunctionBinder binder(context);
+	auto result = binder.BindScalarFunction(DEFAULT_SCHEMA, "struct_extract", std::move(children), error);
+	if (!result) {
+		error.Throw();
+	}
+	return result;
+}
+
+static void SparkMergeSumCount(ClientContext &context, Optimizer &optimizer, unique_ptr<LogicalOperator> &root,
+                               unique_ptr<LogicalOperator> &op) {
+	auto &aggr = op->Cast<LogicalAggregate>();
+
+	// Group the candidates by argument
+	vector<SparkSharedAggregateGroup> groups;
+	vector<idx_t> group_of(aggr.expressions.size(), DConstants::INVALID_INDEX);
+	vector<SparkSharedAggregate> kind_of(aggr.expressions.size(), SparkSharedAggregate::COUNT);
+	for (idx_t i = 0; i < aggr.expressions.size(); i++) {
+		auto &expr = aggr.expressions[i]->Cast<BoundAggregateExpression>();
+		SparkSharedAggregate kind;
+		if (!GetSparkSharedAggregate(expr, kind)) {
+			continue;
+		}
+		idx_t group_idx = 0;
+		for (; group_idx < groups.size(); group_idx++) {
+			auto &first = aggr.expressions[groups[group_idx].members[0]]->Cast<BoundAggregateExpression>();
+			if (first.children[0]->return_type == expr.children[0]->return_type &&
+			    first.children[0]->Equals(*expr.children[0])) {
+				break;
+			}
+		}
+		if (group_idx == groups.size()) {
+			groups.emplace_back();
+		}
+		groups[group_idx].members.push_back(i);
+		groups[group_idx].has_sum_or_avg |= kind != SparkSharedAggregate::COUNT;
+		group_of[i] = group_idx;
+		kind_of[i] = kind;
+	}
+
+	// Bind one spark_sum_count per group before touching the aggregate list. A
+	// group whose fields would not reproduce every member's type is left as is.
+	FunctionBinder function_binder(context);
+	bool any_shared = false;
+	for (idx_t group_idx = 0; group_idx < groups.size(); group_idx++) {
+		auto &group = groups[group_idx];
+		bool shareable = group.members.size() >= 2 && group.has_sum_or_avg;
+		if (shareable) {
+			auto &first = aggr.expressions[group.members[0]]->Cast<BoundAggregateExpression>();
+			vector<unique_ptr<Expression>> children;
+			children.push_back(first.children[0]->Copy());
+			group.shared = function_binder.BindAggregateFunction(CreateSparkSumCountFunction(), std::move(children));
+			for (auto member : group.members) {
+				if (!SparkSharedFieldMatches(group.shared->return_type, kind_of[member],
+				                             aggr.expressions[member]->return_type)) {
+					shareable = false;
+					break;
+				}
+			}
+		}
+		if (!shareable) {
+			for (auto member : group.members) {
+				group_of[member] = DConstants::INVALID_INDEX;
+			}
+			continue;
+		}
+		any_shared = true;
+	}
+	if (!any_shared) {
+		return;
+	}
+
+	// Rewrite the aggregate list: each group shrinks to one spark_sum_count at
+	// the position of its first member. `source` maps every original
+	// aggregate to its position in the new list.
+	vector<unique_ptr<Expression>> expressions;
+	vector<idx_t> source(aggr.expressions.size());
+	for (idx_t i = 0; i < aggr.expressions.size(); i++) {
+		if (group_of[i] == DConstants::INVALID_INDEX) {
+			source[i] = expressions.size();
+			expressions.push_back(std::move(aggr.expressions[i]));
+			continue;
+		}
+		auto &group = groups[group_of[i]];
+		if (group.shared_index == DConstants::INVALID_INDEX) {
+			group.shared_index = expressions.size();
+			expressions.push_back(std::move(group.shared));
+		}
+		source[i] = group.shared_index;
+	}
+	aggr.expressions = std::move(expressions);
+
+	// The projection passes the groups and grouping functions through and
+	// extracts the merged results, keeping the aggregate's column order
+	auto projection_index = optimizer.binder.GenerateTableIndex();
+	vector<unique_ptr<Expression>> select_list;
+	ColumnBindingReplacer replacer;
+	for (idx_t i = 0; i < aggr.groups.size(); i++) {
+		ColumnBinding binding(aggr.group_index, i);
+		replacer.replacement_bindings.emplace_back(binding, ColumnBinding(projection_index, select_list.size()));
+		select_list.push_back(make_uniq<BoundColumnRefExpression>(aggr.groups[i]->return_type, binding));
+	}
+	for (idx_t i = 0; i < source.size(); i++) {
+		replacer.replacement_bindings.emplace_back(ColumnBinding(aggr.aggregate_index, i),
+		                                           ColumnBinding(projection_index, select_list.size()));
+		if (group_of[i] == DConstants::INVALID_INDEX) {
+			auto &kept = *aggr.expressions[source[i]];
+			select_list.push_back(
+			    make_uniq<BoundColumnRefExpression>(kept.return_type, ColumnBinding(aggr.aggregate_index, source[i])));
+		} else {
+			select_list.push_back(BindSparkSharedField(context, aggr, source[i], kind_of[i]));
+		}
+	}
+	for (idx_t i = 0; i < aggr.grouping_functions.size(); i++) {
+		ColumnBinding binding(aggr.groupings_index, i);
+		replacer.replacement_bindings.emplace_back(binding, ColumnBinding(projection_index, select_list.size()));
+		select_list.push_back(make_uniq<BoundColumnRefExpression>(LogicalType::BIGINT, binding));
+	}
+
+	auto projection = make_uniq<LogicalProjection>(projection_index, std::move(select_list));
+	projection->children.push_back(std::move(op));
+	op = std::move(projection);
+	op->ResolveOperatorTypes();
+
+	// Parents now read the projection
+	replacer.stop_operator = op.get();
+	replacer.VisitOperator(*root);
+}
+
+static void SparkMergeSumCountRecursive(ClientContext &context, Optimizer &optimizer,
+                                        unique_ptr<LogicalOperator> &root, unique_ptr<LogicalOperator> &op) {
+	for (auto &child : op->children) {
+		SparkMergeSumCountRecursive(context, optimizer, root, child);
+	}
+	if (op->type == LogicalOperatorType::LOGICAL_AGGREGATE_AND_GROUP_BY) {
+		SparkMergeSumCount(context, optimizer, root, op);
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Fused sum ratio
+// ---------------------------------------------------------------------------
+// The projection directly above an aggregate is the only reader of its
+// bindings, so a division there can be replaced by a reference to a new
+// aggregate, and the sums it read can be dropped when nothing else in the
+// projection reads them. Runs before the shared sum + count rule, so that the
+// dropped sums do not join a spark_sum_count.
+
+struct SparkFusedSumRatio {
+	idx_t a_index; // the spark_sum aggregates divided
+	idx_t b_index;
+	idx_t ratio_index; // position of their spark_sum_ratio in LogicalAggregate::expressions
+};
+
+// Calls callback for every column reference into table_index
+static void SparkVisitColumnRefs(Expression &expr, idx_t table_index,
+                                 const std::function<void(BoundColumnRefExpression &)> &callback) {
+	if (expr.GetExpressionClass() == ExpressionClass::BOUND_COLUMN_REF) {
+		auto &colref = expr.Cast<BoundColumnRefExpression>();
+		if (colref.binding.table_index == table_index) {
+			callback(colref);
+		}
+		return;
+	}
+	ExpressionIterator::EnumerateChildren(
+	    expr, [&](unique_ptr<Expression> &child) { SparkVisitColumnRefs(*child, table_index, callback); });
+}
+
+// The plain spark_sum aggregate behind a column reference of the aggregate
+static bool GetSparkSumRatioOperand(const Expression &expr, const LogicalAggregate &aggr, idx_t &index) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+		return false;
+	}
+	auto &colref = expr.Cast<BoundColumnRefExpression>();
+	if (colref.depth != 0 || colref.binding.table_index != aggr.aggregate_index) {
+		return false;
+	}
+	auto &sum = aggr.expressions[colref.binding.column_index]->Cast<BoundAggregateExpression>();
+	SparkSharedAggregate kind;
+	if (!GetSparkSharedAggregate(sum, kind) || kind != SparkSharedAggregate::SUM) {
+		return false;
+	}
+	index = colref.binding.column_index;
+	return true;
+}
+
+// spark_sum(a) / spark_sum(b) through the DECIMAL `/` or spark_decimal_div
+static bool GetSparkSumRatioOperands(const Expression &expr, const LogicalAggregate &aggr, idx_t &a_index,
+                                     idx_t &b_index) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_FUNCTION ||
+	    expr.return_type.id() != LogicalTypeId::DECIMAL) {
+		return false;
+	}
+	auto &func = expr.Cast<BoundFunctionExpression>();
+	if ((func.function.name != "/" && func.function.name != "spark_decimal_div") || func.children.size() != 2) {
+		return false;
+	}
+	return GetSparkSumRatioOperand(*func.children[0], aggr, a_index) &&
+	       GetSparkSumRatioOperand(*func.children[1], aggr, b_index);
+}
+
+static void SparkFuseSumRatioExpression(FunctionBinder &function_binder, LogicalAggregate &aggr,
+                                        unique_ptr<Expression> &expr, vector<SparkFusedSumRatio> &fused) {
+	idx_t a_index, b_index;
+	if (!GetSparkSumRatioOperands(*expr, aggr, a_index, b_index)) {
+		ExpressionIterator::EnumerateChildren(*expr, [&](unique_ptr<Expression> &child) {
+			SparkFuseSumRatioExpression(function_binder, aggr, child, fused);
+		});
+		return;
+	}
+	idx_t ratio_index = DConstants::INVALID_INDEX;
+	for (auto &entry : fused) {
+		if (entry.a_index == a_index && entry.b_index == b_index) {
+			ratio_index = entry.ratio_index;
+		}
+	}
+	if (ratio_index == DConstants::INVALID_INDEX) {
+		vector<unique_ptr<Expression>> children;
+		children.push_back(aggr.expressions[a_index]->Cast<BoundAggregateExpression>().children[0]->Copy());
+		children.push_back(aggr.expressions[b_index]->Cast<BoundAggregateExpression>().children[0]->Copy());
+		auto ratio = function_binder.BindAggregateFunction(CreateSparkSumRatioFunction(), std::move(children));
+		// Any other DECIMAL division (another `/` overload) is left alone
+		if (ratio->return_type != expr->return_type) {
+			return;
+		}
+		ratio_index = aggr.expressions.size();
+		aggr.expressions.push_back(std::move(ratio));
+		fused.push_back(SparkFusedSumRatio {a_index, b_index, ratio_index});
+	}
+	expr = make_uniq<BoundColumnRefExpression>(expr->alias, expr->return_type,
+	                                           ColumnBinding(aggr.aggregate_index, ratio_index));
+}
+
+static void SparkFuseSumRatio(ClientContext &context, LogicalProjection &projection, LogicalAggregate &aggr) {
+	FunctionBinder function_binder(context);
+	vector<SparkFusedSumRatio> fused;
+	for (auto &expr : projection.expressions) {
+		SparkFuseSumRatioExpression(function_binder, aggr, expr, fused);
+	}
+	if (fused.empty()) {
+		return;
+	}
+
+	// Drop the divided sums that the projection no longer reads
+	vector<bool> dropped(aggr.expressions.size(), false);
+	for (auto &entry : fused) {
+		dropped[entry.a_index] = true;
+		dropped[entry.b_index] = true;
+	}
+	for (auto &expr : projection.expressions) {
+		SparkVisitColumnRefs(*expr, aggr.aggregate_index,
+		                     [&](BoundColumnRefExpression &colref) { dropped[colref.binding.column_index] = false; });
+	}
+	vector<idx_t> remap(aggr.expressions.size(), DConstants::INVALID_INDEX);
+	vector<unique_ptr<Expression>> expressions;
+	for (idx_t i = 0; i < aggr.expressions.size(); i++) {
+		if (!dropped[i]) {
+			remap[i] = expressions.size();
+			expressions.push_back(std::move(aggr.expressions[i]));
+		}
+	}
+	aggr.expressions = std::move(expressions);
+	for (auto &expr : projection.expressions) {
+		SparkVisitColumnRefs(*expr, aggr.aggregate_index, [&](BoundColumnRefExpression &colref) {
+			colref.binding.column_index = remap[colref.binding.column_index];
+		});
+	}
+	aggr.ResolveOperatorTypes();
+}
+
+static void SparkFuseSumRatioRecursive(ClientContext &context, unique_ptr<LogicalOperator> &op) {
+	for (auto &child : op->children) {
+		SparkFuseSumRatioRecursive(context, child);
+	}
+	if (op->type == LogicalOperatorType::LOGICAL_PROJECTION &&
+	    op->children[0]->type == LogicalOperatorType::LOGICAL_AGGREGATE_AND_GROUP_BY) {
+		SparkFuseSumRatio(context, op->Cast<LogicalProjection>(), op->children[0]->Cast<LogicalAggregate>());
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Division comparisons
+// ---------------------------------------------------------------------------
+// A comparison of a Spark DECIMAL division with a constant only needs the
+// side of the constant the quotient falls on, which
+// spark_decimal_div_{eq,ne,lt,le,gt,ge} decide by multiplication. Comparisons
+// of two columns are left alone, so join conditions keep their comparison
+// form. Runs after the sum-ratio rule, which also matches divisions.
+
+// The Spark DECIMAL division under a comparison operand, directly or through
+// a widening cast that keeps its scale (the comparison's common type)
+static BoundFunctionExpression *GetSparkDivComparand(Expression &expr) {
+	if (expr.return_type.id() != LogicalTypeId::DECIMAL) {
+		return nullptr;
+	}
+	Expression *inner = &expr;
+	if (expr.GetExpressionClass() == ExpressionClass::BOUND_CAST) {
+		auto &cast = expr.Cast<BoundCastExpression>();
+		if (cast.try_cast) {
+			return nullptr;
+		}
+		inner = cast.child.get();
+	}
+	if (inner->GetExpressionClass() != ExpressionClass::BOUND_FUNCTION ||
+	    inner->return_type.id() != LogicalTypeId::DECIMAL) {
+		return nullptr;
+	}
+	auto &func = inner->Cast<BoundFunctionExpression>();
+	if (!IsSparkDecimalDivision(func) ||
+	    DecimalType::GetScale(expr.return_type) != DecimalType::GetScale(func.return_type) ||
+	    DecimalType::GetWidth(expr.return_type) < DecimalType::GetWidth(func.return_type)) {
+		return nullptr;
+	}
+	return &func;
+}
+
+class SparkDivComparisonRewriter : public LogicalOperatorVisitor {
+public:
+	explicit SparkDivComparisonRewriter(ClientContext &context) : function_binder(context) {
+	}
+
+	unique_ptr<Expression> VisitReplace(BoundComparisonExpression &expr, unique_ptr<Expression> *expr_ptr) override {
+		auto comparison = expr.GetExpressionType();
+		switch (comparison) {
+		case ExpressionType::COMPARE_EQUAL:
+		case ExpressionType::COMPARE_NOTEQUAL:
+		case ExpressionType::COMPARE_LESSTHAN:
+		case ExpressionType::COMPARE_GREATERTHAN:
+		case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+		case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+			break;
+		default:
+			return nullptr;
+		}
+		auto *division = GetSparkDivComparand(*expr.left);
+		auto *other = &expr.right;
+		if (!division) {
+			division = GetSparkDivComparand(*expr.right);
+			other = &expr.left;
+			comparison = FlipComparisonExpression(comparison);
+		}
+		// The visitor recurses into the operands of a comparison left alone
+		if (!division || !(*other)->IsFoldable()) {
+			return nullptr;
+		}
+
+		vector<unique_ptr<Expression>> children;
+		children.push_back(std::move(division->children[0]));
+		children.push_back(std::move(division->children[1]));
+		children.push_back(std::move(*other));
+		auto result = function_binder.BindScalarFunction(GetSparkDivCompareFunction(comparison), std::move(children));
+		result->alias = expr.alias;
+		VisitExpressionChildren(*result);
+		return result;
+	}
+
+private:
+	FunctionBinder function_binder;
+};
+
+static void SparkPreOptimize(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &plan) {
+	if (SparkRewriteEnabled(input.context, SPARK_CONSTANT_DIVISOR_SETTING)) {
+		SparkConstantDivisorRewriter rewriter(input.context);
+		rewriter.VisitOperator(*plan);
+	}
+	if (SparkRewriteEnabled(input.context, SPARK_FUSED_SUM_RATIO_SETTING)) {
+		SparkFuseSumRatioRecursive(input.context, plan);
+	}
+	if (SparkRewriteEnabled(input.context, SPARK_SHARED_SUM_COUNT_SETTING)) {
+		SparkMergeSumCountRecursive(input.context, input.optimizer, plan, plan);
+	}
+	if (SparkRewriteEnabled(input.context, SPARK_DIV_COMPARISON_SETTING)) {
+		SparkDivComparisonRewriter rewriter(input.context);
+		rewriter.VisitOperator(*plan);
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Registration
+// ---------------------------------------------------------------------------
+
+void RegisterSparkOptimizerRules(ExtensionLoader &loader) {
+	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+	config.AddExtensionOption(SPARK_CONSTANT_DIVISOR_SETTING,
+	                          "Fold constant operands of DECIMAL divisions so that the divisor's reciprocal is "
+	                          "precomputed once",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(true));
+	config.AddExtensionOption(SPARK_SHARED_SUM_COUNT_SETTING,
+	                          "Merge spark_sum, spark_avg and count over the same DECIMAL argument into one shared "
+	                          "spark_sum_count aggregate",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(true));
+	config.AddExtensionOption(SPARK_FUSED_SUM_RATIO_SETTING,
+	                          "Compute spark_sum(a) / spark_sum(b) as one spark_sum_ratio(a, b) aggregate",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(true));
+	config.AddExtensionOption(SPARK_DIV_COMPARISON_SETTING,
+	                          "Decide comparisons of a DECIMAL division with a constant without computing the quotient",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(true));
+
+	OptimizerExtension extension;
+	extension.pre_optimize_function = SparkPreOptimize;
+	config.optimizer_extensions.push_back(std::move(extension));
+}
+
+} // namespace duckdb
@@ -0,0 +1,172 @@
+#include "spark_round.hpp"
+#include "spark_ansi.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/types/decimal.hpp"
+#include "duckdb/common/vector_operations/unary_executor.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/function/scalar_function.hpp"
+#include "duckdb/function/function_set.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+
+namespace duckdb {
+
+// ---------------------------------------------------------------------------
+// Functions
+// ---------------------------------------------------------------------------
+
+struct SparkRoundOp {
+	static constexpr const char *NAME = "spark_round";
+	static constexpr SparkRoundMode MODE = SparkRoundMode::HALF_UP;
+};
+
+struct SparkBroundOp {
+	static constexpr const char *NAME = "spark_bround";
+	static constexpr SparkRoundMode MODE = SparkRoundMode::HALF_EVEN;
+};
+
+struct SparkCeilOp {
+	static constexpr const char *NAME = "spark_ceil";
+	static constexpr SparkRoundMode MODE = SparkRoundMode::CEILING;
+};
+
+struct SparkFloorOp {
+	static constexpr const char *NAME = "spark_floor";
+	static constexpr SparkRoundMode MODE = SparkRoundMode::FLOOR;
+};
+
+// ---------------------------------------------------------------------------
+// Execution: the input is read in its native width and rounded straight into
+// the result type, with no cast pass in between
+// ---------------------------------------------------------------------------
+
+template <typename A_TYPE, typename RESULT_TYPE, typename T, SparkRoundMode MODE>
+static void SparkRoundExec(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &bind_data = func_expr.bind_info->Cast<SparkRoundBindData>();
+	auto &params = bind_data.Params(T());
+
+	idx_t overflow_count = 0;
+	UnaryExecutor::ExecuteWithNulls<A_TYPE, RESULT_TYPE>(
+	    args.data[0], result, args.size(), [&](const A_TYPE &input, ValidityMask &mask, idx_t idx) {
+		    T value;
+		    if (!SparkRoundScaled<T, MODE>(static_cast<T>(DecimalToInt128(input)), params, value)) {
+			    mask.SetInvalid(idx);
+			    overflow_count++;
+			    return RESULT_TYPE(0);
+		    }
+		    return Int128ToDecimal<RESULT_TYPE>(value);
+	    });
+	if (overflow_count > 0 && bind_data.ansi) {
+		ThrowSparkDecimalOverflow(result.GetType());
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Kernel selection: one instantiation per (input, result) physical type
+// ---------------------------------------------------------------------------
+
+// 64-bit arithmetic whenever both sides fit in 18 digits.
+template <typename A_TYPE, typename RESULT_TYPE, SparkRoundMode MODE>
+static scalar_function_t GetSparkRoundKernel() {
+	using COMPUTE = typename std::conditional<sizeof(A_TYPE) <= sizeof(int64_t) && sizeof(RESULT_TYPE) <= sizeof(int64_t),
+	                                          int64_t, __int128>::type;
+	return SparkRoundExec<A_TYPE, RESULT_TYPE, COMPUTE, MODE>;
+}
+
+template <typename A_TYPE, SparkRoundMode MODE>
+static scalar_function_t GetSparkRoundKernel(PhysicalType result_type) {
+	switch (result_type) {
+	case PhysicalType::INT16:
+		return GetSparkRoundKernel<A_TYPE, int16_t, MODE>();
+	case PhysicalType::INT32:
+		return GetSparkRoundKernel<A_TYPE, int32_t, MODE>();
+	case PhysicalType::INT64:
+		return GetSparkRoundKernel<A_TYPE, int64_t, MODE>();
+	case PhysicalType::INT128:
+		return GetSparkRoundKernel<A_TYPE, hugeint_t, MODE>();
+	default:
+		throw InternalException("Unexpected physical type for DECIMAL result");
+	}
+}
+
+template <SparkRoundMode MODE>
+static scalar_function_t GetSparkRoundKernel(PhysicalType input_type, PhysicalType result_type) {
+	switch (input_type) {
+	case PhysicalType::INT16:
+		return GetSparkRoundKernel<int16_t, MODE>(result_type);
+	case PhysicalType::INT32:
+		return GetSparkRoundKernel<int32_t, MODE>(result_type);
+	case PhysicalType::INT64:
+		return GetSparkRoundKernel<int64_t, MODE>(result_type);
+	case PhysicalType::INT128:
+		return GetSparkRoundKernel<hugeint_t, MODE>(result_type);
+	default:
+		throw InternalException("Unexpected physical type for DECIMAL input");
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Bind function: resolve types and select implementation
+// ---------------------------------------------------------------------------
+
+template <typename OP>
+static unique_ptr<FunctionData> BindSparkDecimalRound(ClientContext &context, ScalarFunction &bound_function,
+                                                      vector<unique_ptr<Expression>> &arguments) {
+	auto &type = arguments[0]->return_type;
+	if (type.id() != LogicalTypeId::DECIMAL) {
+		throw InvalidInputException("%s requires DECIMAL argument, got %s", OP::NAME, type.ToString());
+	}
+	// Like Spark, the scale must be foldable
+	int64_t n = 0;
+	if (arguments.size() == 2) {
+		if (!arguments[1]->IsFoldable()) {
+			throw BinderException("%s: scale must be a constant", OP::NAME);
+		}
+		auto scale_value = ExpressionExecutor::EvaluateScalar(context, *arguments[1]);
+		if (scale_value.IsNull()) {
+			throw BinderException("%s: scale cannot be NULL", OP::NAME);
+		}
+		n = scale_value.GetValue<int32_t>();
+		Function::EraseArgument(bound_function, arguments, 1);
+	}
+
+	uint8_t p = DecimalType::GetWidth(type);
+	uint8_t s = DecimalType::GetScale(type);
+	auto result = ComputeRoundType(p, s, n);
+	auto result_type = LogicalType::DECIMAL(result.precision, result.scale);
+
+	bound_function.arguments[0] = type;
+	bound_function.return_type = result_type;
+	bound_function.function = GetSparkRoundKernel<OP::MODE>(type.InternalType(), result_type.InternalType());
+
+	// The int64_t parameters are only used when input and result fit 18 digits
+	auto params64 = MakeSparkRoundParams<int64_t>(s, n, result.precision <= 18 ? result : SparkDecimalResult {18, 0},
+	                                              18);
+	auto params128 = MakeSparkRoundParams<__int128>(s, n, result, 38);
+	return make_uniq<SparkRoundBindData>(params64, params128, SparkAnsiEnabled(context));
+}
+
+// ---------------------------------------------------------------------------
+// Registration
+// ---------------------------------------------------------------------------
+
+template <typename OP>
+static ScalarFunctionSet GetSparkRoundFunctionSet() {
+	ScalarFunctionSet set(OP::NAME);
+	auto kernel = SparkRoundExec<hugeint_t, hugeint_t, __int128, OP::MODE>;
+	set.AddFunction(ScalarFunction({LogicalType::ANY}, LogicalType::ANY, kernel, BindSparkDecimalRound<OP>));
+	set.AddFunction(ScalarFunction({LogicalType::ANY, LogicalType::INTEGER}, LogicalType::ANY, kernel,
+	                               BindSparkDecimalRound<OP>));
+	return set;
+}
+
+void RegisterSparkRoundFunctions(ExtensionLoader &loader) {
+	loader.RegisterFunction(GetSparkRoundFunctionSet<SparkRoundOp>());
+	loader.RegisterFunction(GetSparkRoundFunctionSet<SparkBroundOp>());
+	loader.RegisterFunction(GetSparkRoundFunctionSet<SparkCeilOp>());
+	loader.RegisterFunction(GetSparkRoundFunctionSet<SparkFloorOp>());
+}
+
+} // namespace duckdb
@@ -4,11 +4,28 @@
 #include "spark_precision.hpp"
 #include "decimal_division.hpp"
 #include "spark_aggregates.hpp"
+#include "spark_distinct.hpp"
+#include "spark_partial_state.hpp"
+#include "spark_statistics.hpp"
+#include "spark_arithmetic.hpp"
+#include "spark_counters.hpp"
+#include "spark_ansi.hpp"
+#include "spark_decimal_string.hpp"
+#include "spark_round.hpp"
+#include "spark_divmod.hpp"
+#include "spark_div_compare.hpp"
+#include "spark_sum_count.hpp"
+#include "spark_sum_ratio.hpp"
+#include "spark_optimizer.hpp"
+#include "spark_hash.hpp"
 
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/types/decimal.hpp"
+#include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/function/scalar_function.hpp"
 #include "duckdb/function/function_set.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
 #include "duckdb/planner/expression/bound_function_expression.hpp"
 
 namespace duckdb {
@@ -28,34 +45,262 @@ inline void WriteResult<hugeint_t>(hugeint_t *data, idx_t idx, __int128 val) {
 	data[idx] = Int128ToHugeint(val);
 }
 
+// ---------------------------------------------------------------------------
+// Per-row division operators
+// ---------------------------------------------------------------------------
+// A_TYPE / B_TYPE are the physical C++ types of the input DECIMALs. The bind
+// function picks the cheapest operator that is valid for the declared types.
+
+// Generic path: any input width, full 128/256-bit SparkDecimalDivide.
+struct SparkDivWideOp {
+	template <typename A_TYPE, typename B_TYPE>
+	static inline __int128 Operation(const A_TYPE &a, const B_TYPE &b, const SparkDivScale &scale) {
+		return SparkDecimalDivide(DecimalToInt128(a), DecimalToInt128(b), scale.pow10_val, scale.pow10_extra);
+	}
+
+	template <typename A_TYPE>
+	static inline __int128 OperationConstant(const A_TYPE &a, const SparkConstantDivisor &divisor,
+	                                         const SparkDivScale &scale) {
+		return SparkDecimalDivideConstant(DecimalToInt128(a), divisor, scale.pow10_val, scale.pow10_extra);
+	}
+};
+
+// Both inputs fit in 64 bits: 64-bit arithmetic when the scaled dividend fits,
+// checked per row. SCALE is SparkDivScale or SparkDivFixedScale.
+struct SparkDivNarrowOp {
+	template <typename A_TYPE, typename B_TYPE, typename SCALE>
+	static inline __int128 Operation(const A_TYPE &a, const B_TYPE &b, const SCALE &scale) {
+		return SparkDecimalDivideNarrow(DecimalToInt64(a), DecimalToInt64(b), scale);
+	}
+
+	template <typename A_TYPE, typename SCALE>
+	static inline __int128 OperationConstant(const A_TYPE &a, const SparkConstantDivisor &divisor,
+	                                         const SCALE &scale) {
+		return SparkDecimalDivideNarrowConstant(DecimalToInt64(a), divisor, scale);
+	}
+};
+
+// The scaled dividend is known at bind time to fit in 64 bits: no overflow check.
+struct SparkDiv64Op {
+	template <typename A_TYPE, typename B_TYPE, typename SCALE>
+	static inline __int128 Operation(const A_TYPE &a, const B_TYPE &b, const SCALE &scale) {
+		return SparkDecimalDivide64(DecimalToInt64(a) * scale.pow10_64, DecimalToInt64(b));
+	}
+
+	template <typename A_TYPE, typename SCALE>
+	static inline __int128 OperationConstant(const A_TYPE &a, const SparkConstantDivisor &divisor,
+	                                         const SCALE &scale) {
+		return SparkDecimalDivide64Constant(DecimalToInt64(a) * scale.pow10_64, divisor);
+	}
+};
+
+// OP with scale_adj fixed at compile time (see SparkDivFixedScale); the
+// runtime scale handed down by the execution loops is ignored.
+template <typename OP, uint32_t SCALE_ADJ>
+struct SparkDivFixedScaleOp {
+	template <typename A_TYPE, typename B_TYPE>
+	static inline __int128 Operation(const A_TYPE &a, const B_TYPE &b, const SparkDivScale &) {
+		return OP::Operation(a, b, SparkDivFixedScale<SCALE_ADJ>());
+	}
+
+	template <typename A_TYPE>
+	static inline __int128 OperationConstant(const A_TYPE &a, const SparkConstantDivisor &divisor,
+	                                         const SparkDivScale &) {
+		return OP::OperationConstant(a, divisor, SparkDivFixedScale<SCALE_ADJ>());
+	}
+};
+
 // ---------------------------------------------------------------------------
 // Execution function template
 // ---------------------------------------------------------------------------
 // RESULT_TYPE is the physical C++ type for the output DECIMAL
 // (int16_t, int32_t, int64_t, or hugeint_t).
-// Inputs are always hugeint_t because we promote both arguments to DECIMAL(38, s).
+// Inputs keep their declared DECIMAL type, so no cast to DECIMAL(38, s) is needed.
+
+// Tight loop over flat inputs. `mask` is the result validity: it already holds
+// the combined input NULLs and the zero-divisor rows, so the per-row body has no
+// data-dependent branch. Validity is inspected once per 64-row entry; fully valid
+// entries run the unconditional loop, fully invalid entries are skipped.
+template <typename A_TYPE, typename B_TYPE, typename RESULT_TYPE, bool LEFT_CONSTANT, bool RIGHT_CONSTANT,
+          typename FUNC>
+static void SparkDivFlatLoop(const A_TYPE *__restrict a_data, const B_TYPE *__restrict b_data,
+                             RESULT_TYPE *__restrict result_data, idx_t count, ValidityMask &mask, FUNC fun) {
+	if (mask.AllValid()) {
+		for (idx_t i = 0; i < count; i++) {
+			WriteResult(result_data, i, fun(a_data[LEFT_CONSTANT ? 0 : i], b_data[RIGHT_CONSTANT ? 0 : i]));
+		}
+		return;
+	}
+	idx_t base_idx = 0;
+	auto entry_count = ValidityMask::EntryCount(count);
+	for (idx_t entry_idx = 0; entry_idx < entry_count; entry_idx++) {
+		auto validity_entry = mask.GetValidityEntry(entry_idx);
+		idx_t next = MinValue<idx_t>(base_idx + ValidityMask::BITS_PER_VALUE, count);
+		if (ValidityMask::AllValid(validity_entry)) {
+			for (; base_idx < next; base_idx++) {
+				WriteResult(result_data, base_idx,
+				            fun(a_data[LEFT_CONSTANT ? 0 : base_idx], b_data[RIGHT_CONSTANT ? 0 : base_idx]));
+			}
+		} else if (ValidityMask::NoneValid(validity_entry)) {
+			base_idx = next;
+		} else {
+			idx_t start = base_idx;
+			for (; base_idx < next; base_idx++) {
+				if (ValidityMask::RowIsValid(validity_entry, base_idx - start)) {
+					WriteResult(result_data, base_idx,
+					            fun(a_data[LEFT_CONSTANT ? 0 : base_idx], b_data[RIGHT_CONSTANT ? 0 : base_idx]));
+				}
+			}
+		}
+	}
+}
 
-template <typename RESULT_TYPE>
-static void SparkDivExec(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
-	auto &bind_data = func_expr.bind_info->Cast<SparkDivBindData>();
-	uint32_t scale_adj = bind_data.scale_adj;
+// Separate masked pass for division by zero: a branch-free scan detects whether
+// any divisor is zero, and only then are the affected rows marked NULL.
+template <typename B_TYPE>
+static void SparkDivMaskZeroDivisors(const B_TYPE *__restrict b_data, idx_t count, ValidityMask &mask) {
+	bool has_zero = false;
+	for (idx_t i = 0; i < count; i++) {
+		has_zero |= b_data[i] == B_TYPE(0);
+	}
+	if (__builtin_expect(!has_zero, 1)) {
+		return;
+	}
+	idx_t zero_count = 0;
+	for (idx_t i = 0; i < count; i++) {
+		if (b_data[i] == B_TYPE(0) && mask.RowIsValid(i)) {
+			mask.SetInvalid(i);
+			zero_count++;
+		}
+	}
+	SparkCountAdd(SparkCounter::DIV_ZERO_DIVISOR_ROWS, zero_count);
+}
 
-	// Precompute power-of-10 once for the entire batch (scale_adj is constant)
-	unsigned __int128 pow10_val = (scale_adj > 0) ? Pow10_128(scale_adj) : 0;
+// Constant divisor loop: fun(a, b) for every valid row of `a`.
+template <typename A_TYPE, typename B_TYPE, typename RESULT_TYPE, typename FUNC>
+static void SparkDivConstantDivisorLoop(Vector &a, const B_TYPE &b, Vector &result, idx_t count, FUNC fun) {
+	switch (a.GetVectorType()) {
+	case VectorType::CONSTANT_VECTOR: {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+		if (ConstantVector::IsNull(a)) {
+			ConstantVector::SetNull(result, true);
+			return;
+		}
+		auto *result_data = ConstantVector::GetData<RESULT_TYPE>(result);
+		WriteResult(result_data, 0, fun(*ConstantVector::GetData<A_TYPE>(a), b));
+		return;
+	}
+	case VectorType::FLAT_VECTOR: {
+		result.SetVectorType(VectorType::FLAT_VECTOR);
+		auto &result_validity = FlatVector::Validity(result);
+		result_validity.Copy(FlatVector::Validity(a), count);
+		SparkDivFlatLoop<A_TYPE, B_TYPE, RESULT_TYPE, false, true>(FlatVector::GetData<A_TYPE>(a), &b,
+		                                                           FlatVector::GetData<RESULT_TYPE>(result), count,
+		                                                           result_validity, fun);
+		return;
+	}
+	default:
+		break;
+	}
 
-	idx_t count = args.size();
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto *__restrict result_data = FlatVector::GetData<RESULT_TYPE>(result);
+	auto &result_validity = FlatVector::Validity(result);
+
+	UnifiedVectorFormat a_fmt;
+	a.ToUnifiedFormat(count, a_fmt);
+	const auto *__restrict a_data = UnifiedVectorFormat::GetData<A_TYPE>(a_fmt);
+
+	for (idx_t i = 0; i < count; i++) {
+		auto a_idx = a_fmt.sel->get_index(i);
+		if (!a_fmt.validity.RowIsValid(a_idx)) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		WriteResult(result_data, i, fun(a_data[a_idx], b));
+	}
+}
+
+// Constant divisor: every row divides by the same value, so the reciprocal is
+// computed once (at bind time when the divisor is a constant, otherwise here,
+// e.g. for a prepared-statement parameter). A divisor of 10^scale_adj (10.0,
+// 100, 0.5, 25, ...) replaces the division by one multiply
+// (SparkConstantDivisor::SetExactMultiplier): a power of ten only rescales.
+// The caller has already handled a NULL or zero divisor.
+template <typename A_TYPE, typename B_TYPE, typename RESULT_TYPE, typename OP>
+static void SparkDivConstantDivisorExec(Vector &a, const B_TYPE &b, const SparkDivBindData &bind_data,
+                                        const SparkDivScale &scale, Vector &result, idx_t count) {
+	__int128 b_val = DecimalToInt128(b);
+	SparkConstantDivisor divisor;
+	if (bind_data.has_constant_divisor && bind_data.divisor.Matches(b_val)) {
+		divisor = bind_data.divisor;
+	} else {
+		divisor = SparkConstantDivisor(b_val);
+		divisor.SetExactMultiplier(bind_data.scale_adj);
+	}
+	SparkCountAdd(SparkCounter::DIV_CONSTANT_DIVISOR_ROWS, count);
+
+	if (divisor.exact_multiplier != 0) {
+		auto exact = [&](const A_TYPE &a_val, const B_TYPE &) {
+			return SparkDecimalDivideExact(DecimalToInt128(a_val), divisor);
+		};
+		SparkDivConstantDivisorLoop<A_TYPE, B_TYPE, RESULT_TYPE>(a, b, result, count, exact);
+		return;
+	}
+	auto fun = [&](const A_TYPE &a_val, const B_TYPE &) {
+		return OP::OperationConstant(a_val, divisor, scale);
+	};
+	SparkDivConstantDivisorLoop<A_TYPE, B_TYPE, RESULT_TYPE>(a, b, result, count, fun);
+}
+
+// Constant dividend over a flat divisor (e.g. `1 / x`).
+template <typename A_TYPE, typename B_TYPE, typename RESULT_TYPE, typename OP>
+static void SparkDivConstantDividendExec(Vector &a, Vector &b, const SparkDivScale &scale, Vector &result,
+                                         idx_t count) {
+	if (ConstantVector::IsNull(a)) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+		ConstantVector::SetNull(result, true);
+		return;
+	}
+	const auto *b_data = FlatVector::GetData<B_TYPE>(b);
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto &result_validity = FlatVector::Validity(result);
+	result_validity.Copy(FlatVector::Validity(b), count);
+	SparkDivMaskZeroDivisors(b_data, count, result_validity);
+	SparkDivFlatLoop<A_TYPE, B_TYPE, RESULT_TYPE, true, false>(
+	    ConstantVector::GetData<A_TYPE>(a), b_data, FlatVector::GetData<RESULT_TYPE>(result), count, result_validity,
+	    [&](const A_TYPE &a_val, const B_TYPE &b_val) { return OP::Operation(a_val, b_val, scale); });
+}
+
+// Both inputs flat.
+template <typename A_TYPE, typename B_TYPE, typename RESULT_TYPE, typename OP>
+static void SparkDivFlatExec(Vector &a, Vector &b, const SparkDivScale &scale, Vector &result, idx_t count) {
+	const auto *b_data = FlatVector::GetData<B_TYPE>(b);
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto &result_validity = FlatVector::Validity(result);
+	result_validity.Copy(FlatVector::Validity(a), count);
+	result_validity.Combine(FlatVector::Validity(b), count);
+	SparkDivMaskZeroDivisors(b_data, count, result_validity);
+	SparkDivFlatLoop<A_TYPE, B_TYPE, RESULT_TYPE, false, false>(
+	    FlatVector::GetData<A_TYPE>(a), b_data, FlatVector::GetData<RESULT_TYPE>(result), count, result_validity,
+	    [&](const A_TYPE &a_val, const B_TYPE &b_val) { return OP::Operation(a_val, b_val, scale); });
+}
+
+// Any other vector shape (dictionary, sequence, ...): unified format, per-row checks.
+template <typename A_TYPE, typename B_TYPE, typename RESULT_TYPE, typename OP>
+static void SparkDivGenericExec(Vector &a, Vector &b, const SparkDivScale &scale, Vector &result, idx_t count) {
 	result.SetVectorType(VectorType::FLAT_VECTOR);
 	auto *__restrict result_data = FlatVector::GetData<RESULT_TYPE>(result);
 	auto &result_validity = FlatVector::Validity(result);
 
 	UnifiedVectorFormat a_fmt, b_fmt;
-	args.data[0].ToUnifiedFormat(count, a_fmt);
-	args.data[1].ToUnifiedFormat(count, b_fmt);
+	a.ToUnifiedFormat(count, a_fmt);
+	b.ToUnifiedFormat(count, b_fmt);
 
-	const auto *__restrict a_data = UnifiedVectorFormat::GetData<hugeint_t>(a_fmt);
-	const auto *__restrict b_data = UnifiedVectorFormat::GetData<hugeint_t>(b_fmt);
+	const auto *__restrict a_data = UnifiedVectorFormat::GetData<A_TYPE>(a_fmt);
+	const auto *__restrict b_data = UnifiedVectorFormat::GetData<B_TYPE>(b_fmt);
 
+	idx_t zero_count = 0;
 	for (idx_t i = 0; i < count; i++) {
 		auto a_idx = a_fmt.sel->get_index(i);
 		auto b_idx = b_fmt.sel->get_index(i);
@@ -66,20 +311,311 @@ static void SparkDivExec(DataChunk &args, ExpressionState &state, Vector &result
 			continue;
 		}
 
-		__int128 b_val = HugeintToInt128(b_data[b_idx]);
-
 		// Division by zero -> NULL (unlikely in normal data)
-		if (__builtin_expect(b_val == 0, 0)) {
+		if (__builtin_expect(b_data[b_idx] == B_TYPE(0), 0)) {
 			result_validity.SetInvalid(i);
+			zero_count++;
 			continue;
 		}
 
-		__int128 a_val = HugeintToInt128(a_data[a_idx]);
-		__int128 div_result = SparkDecimalDivide(a_val, b_val, pow10_val);
+		__int128 div_result = OP::Operation(a_data[a_idx], b_data[b_idx], scale);
 
 		// Write result, converting from __int128 to the target physical type
 		WriteResult(result_data, i, div_result);
 	}
+	SparkCountAdd(SparkCounter::DIV_ZERO_DIVISOR_ROWS, zero_count);
+}
+
+// Number of dictionary entries the rows can reference: the dictionary size when
+// the producer recorded it, otherwise one past the largest selected index.
+static idx_t SparkDictionaryEntryCount(Vector &dict, idx_t count) {
+	auto dictionary_size = DictionaryVector::DictionarySize(dict);
+	if (dictionary_size.IsValid()) {
+		return dictionary_size.GetIndex();
+	}
+	auto &sel = DictionaryVector::SelVector(dict);
+	idx_t max_index = 0;
+	for (idx_t i = 0; i < count; i++) {
+		max_index = MaxValue<idx_t>(max_index, sel.get_index(i));
+	}
+	return count == 0 ? 0 : max_index + 1;
+}
+
+template <typename A_TYPE, typename B_TYPE, typename RESULT_TYPE, typename OP>
+static void SparkDivExecuteVectors(Vector &a, Vector &b, const SparkDivBindData &bind_data, Vector &result,
+                                   idx_t count);
+
+// Rows whose dictionary entry is a (valid) zero divisor.
+template <typename B_TYPE>
+static idx_t SparkDictionaryZeroRows(Vector &entries, idx_t entry_count, const SelectionVector &sel, idx_t count) {
+	UnifiedVectorFormat entry_fmt;
+	entries.ToUnifiedFormat(entry_count, entry_fmt);
+	const auto *entry_data = UnifiedVectorFormat::GetData<B_TYPE>(entry_fmt);
+	idx_t zero_rows = 0;
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = entry_fmt.sel->get_index(sel.get_index(i));
+		zero_rows += entry_fmt.validity.RowIsValid(idx) && entry_data[idx] == B_TYPE(0);
+	}
+	return zero_rows;
+}
+
+// Range check of the entry quotients (legacy mode). Returns the number of rows
+// that reference an entry it nulled.
+template <typename RESULT_TYPE>
+static idx_t SparkDictionaryEnforceRange(Vector &entry_result, idx_t entry_count, const SelectionVector &sel,
+                                         idx_t count) {
+	if (entry_result.GetVectorType() == VectorType::CONSTANT_VECTOR) {
+		return SparkEnforceDecimalRange<RESULT_TYPE>(entry_result, entry_count, false) ? count : 0;
+	}
+	ValidityMask entry_validity;
+	entry_validity.Copy(FlatVector::Validity(entry_result), entry_count);
+	if (__builtin_expect(SparkEnforceDecimalRange<RESULT_TYPE>(entry_result, entry_count, false) == 0, 1)) {
+		return 0;
+	}
+	auto &checked = FlatVector::Validity(entry_result);
+	idx_t overflow_rows = 0;
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = sel.get_index(i);
+		overflow_rows += entry_validity.RowIsValid(idx) && !checked.RowIsValid(idx);
+	}
+	return overflow_rows;
+}
+
+// A dictionary input against a constant (e.g. a divisor from a low-cardinality
+// dimension join): each dictionary entry is divided once and the result is a
+// dictionary over those quotients, sharing the input's selection vector.
+// Returns false when the dictionary is not smaller than the vector, or when the
+// divisor is a NULL or zero constant (the plain path answers those at once).
+// Also skipped when an overflow must raise an error (ANSI mode), because an
+// overflowing entry may not be referenced by any row.
+//
+// The counters count rows, not entries: the entry kernels run with counting
+// paused, and the rows are counted from the selection vector afterwards.
+template <typename A_TYPE, typename B_TYPE, typename RESULT_TYPE, typename OP>
+static bool SparkDivDictionaryExec(Vector &a, Vector &b, const SparkDivBindData &bind_data, Vector &result,
+                                   idx_t count) {
+	if (bind_data.check_range && bind_data.ansi) {
+		return false;
+	}
+	bool dictionary_dividend = a.GetVectorType() == VectorType::DICTIONARY_VECTOR;
+	if (dictionary_dividend && (ConstantVector::IsNull(b) || *ConstantVector::GetData<B_TYPE>(b) == B_TYPE(0))) {
+		return false;
+	}
+	auto &dict = dictionary_dividend ? a : b;
+	idx_t entry_count = SparkDictionaryEntryCount(dict, count);
+	if (entry_count >= count) {
+		return false;
+	}
+	auto &entries = DictionaryVector::Child(dict);
+	auto &sel = DictionaryVector::SelVector(dict);
+	Vector entry_result(result.GetType(), entry_count);
+	{
+		SparkCountersPause pause;
+		if (dictionary_dividend) {
+			SparkDivExecuteVectors<A_TYPE, B_TYPE, RESULT_TYPE, OP>(entries, b, bind_data, entry_result, entry_count);
+		} else {
+			SparkDivExecuteVectors<A_TYPE, B_TYPE, RESULT_TYPE, OP>(a, entries, bind_data, entry_result, entry_count);
+		}
+	}
+	SparkCountAdd(SparkCounter::DIV_DICTIONARY_ROWS, count);
+	if (dictionary_dividend) {
+		SparkCountAdd(SparkCounter::DIV_CONSTANT_DIVISOR_ROWS, count);
+	} else if (!ConstantVector::IsNull(a)) {
+		SparkCountAdd(SparkCounter::DIV_ZERO_DIVISOR_ROWS,
+		              SparkDictionaryZeroRows<B_TYPE>(entries, entry_count, sel, count));
+	}
+	// Range-checked here, per entry: SparkDivExec leaves dictionary results alone
+	if (bind_data.check_range) {
+		SparkCountAdd(SparkCounter::DIV_OVERFLOW_ROWS,
+		              SparkDictionaryEnforceRange<RESULT_TYPE>(entry_result, entry_count, sel, count));
+	}
+	result.Slice(entry_result, sel, count);
+	return true;
+}
+
+// Dispatch on the vector shapes of both inputs.
+template <typename A_TYPE, typename B_TYPE, typename RESULT_TYPE, typename OP>
+static void SparkDivExecuteVectors(Vector &a, Vector &b, const SparkDivBindData &bind_data, Vector &result,
+                                   idx_t count) {
+	// Precompute power-of-10 once for the entire batch (scale_adj is constant)
+	SparkDivScale scale(bind_data.scale_adj);
+
+	auto a_vtype = a.GetVectorType();
+	auto b_vtype = b.GetVectorType();
+	if (((a_vtype == VectorType::DICTIONARY_VECTOR && b_vtype == VectorType::CONSTANT_VECTOR) ||
+	     (a_vtype == VectorType::CONSTANT_VECTOR && b_vtype == VectorType::DICTIONARY_VECTOR)) &&
+	    SparkDivDictionaryExec<A_TYPE, B_TYPE, RESULT_TYPE, OP>(a, b, bind_data, result, count)) {
+		return;
+	}
+	if (b_vtype == VectorType::CONSTANT_VECTOR) {
+		// NULL or zero divisor -> every row is NULL
+		auto &b_const = *ConstantVector::GetData<B_TYPE>(b);
+		if (ConstantVector::IsNull(b) || b_const == B_TYPE(0)) {
+			if (!ConstantVector::IsNull(b)) {
+				SparkCountAdd(SparkCounter::DIV_ZERO_DIVISOR_ROWS, count);
+			}
+			result.SetVectorType(VectorType::CONSTANT_VECTOR);
+			ConstantVector::SetNull(result, true);
+			return;
+		}
+		SparkDivConstantDivisorExec<A_TYPE, B_TYPE, RESULT_TYPE, OP>(a, b_const, bind_data, scale, result, count);
+	} else if (a_vtype == VectorType::FLAT_VECTOR && b_vtype == VectorType::FLAT_VECTOR) {
+		SparkDivFlatExec<A_TYPE, B_TYPE, RESULT_TYPE, OP>(a, b, scale, result, count);
+	} else if (a_vtype == VectorType::CONSTANT_VECTOR && b_vtype == VectorType::FLAT_VECTOR) {
+		SparkDivConstantDividendExec<A_TYPE, B_TYPE, RESULT_TYPE, OP>(a, b, scale, result, count);
+	} else {
+		SparkDivGenericExec<A_TYPE, B_TYPE, RESULT_TYPE, OP>(a, b, scale, result, count);
+	}
+}
+
+// Valid dividends whose scaled value |a| * 10^scale_adj exceeds 128 bits, i.e.
+// the rows that take the 256-bit path. A separate branch-free pass, so the
+// division loops stay free of counting; it only runs when the bind data says
+// such dividends can occur.
+template <typename A_TYPE>
+static idx_t SparkDivCountWideRows(Vector &a, idx_t count, uint32_t scale_adj) {
+	unsigned __int128 threshold = SparkDivScale(scale_adj).MaxDividend128();
+	UnifiedVectorFormat a_fmt;
+	a.ToUnifiedFormat(a.GetVectorType() == VectorType::CONSTANT_VECTOR ? 1 : count, a_fmt);
+	const auto *a_data = UnifiedVectorFormat::GetData<A_TYPE>(a_fmt);
+	if (a.GetVectorType() == VectorType::CONSTANT_VECTOR) {
+		bool wide = a_fmt.validity.RowIsValid(0) && Abs128(DecimalToInt128(a_data[0])) > threshold;
+		return wide ? count : 0;
+	}
+	idx_t wide_count = 0;
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = a_fmt.sel->get_index(i);
+		wide_count += a_fmt.validity.RowIsValid(idx) && Abs128(DecimalToInt128(a_data[idx])) > threshold;
+	}
+	return wide_count;
+}
+
+template <typename A_TYPE, typename B_TYPE, typename RESULT_TYPE, typename OP>
+static void SparkDivExec(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &bind_data = func_expr.bind_info->Cast<SparkDivBindData>();
+	SparkCountAdd(SparkCounter::DIV_ROWS, args.size());
+	if (bind_data.may_overflow_128) {
+		SparkCountAdd(SparkCounter::DIV_WIDE_ROWS,
+		              SparkDivCountWideRows<A_TYPE>(args.data[0], args.size(), bind_data.scale_adj));
+	}
+	SparkDivExecuteVectors<A_TYPE, B_TYPE, RESULT_TYPE, OP>(args.data[0], args.data[1], bind_data, result,
+	                                                        args.size());
+	if (bind_data.check_range && result.GetVectorType() != VectorType::DICTIONARY_VECTOR) {
+		SparkCountAdd(SparkCounter::DIV_OVERFLOW_ROWS,
+		              SparkEnforceDecimalRange<RESULT_TYPE>(result, args.size(), bind_data.ansi));
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Kernel selection: one instantiation per (input, input, result) physical type
+// ---------------------------------------------------------------------------
+
+template <typename A_TYPE, typename B_TYPE, typename OP>
+static scalar_function_t GetSparkDivKernel(PhysicalType result_type) {
+	switch (result_type) {
+	case PhysicalType::INT16:
+		return SparkDivExec<A_TYPE, B_TYPE, int16_t, OP>;
+	case PhysicalType::INT32:
+		return SparkDivExec<A_TYPE, B_TYPE, int32_t, OP>;
+	case PhysicalType::INT64:
+		return SparkDivExec<A_TYPE, B_TYPE, int64_t, OP>;
+	case PhysicalType::INT128:
+		return SparkDivExec<A_TYPE, B_TYPE, hugeint_t, OP>;
+	default:
+		throw InternalException("Unexpected physical type for DECIMAL result");
+	}
+}
+
+template <typename A_TYPE, typename OP>
+static scalar_function_t GetSparkDivKernel(PhysicalType b_type, PhysicalType result_type) {
+	switch (b_type) {
+	case PhysicalType::INT16:
+		return GetSparkDivKernel<A_TYPE, int16_t, OP>(result_type);
+	case PhysicalType::INT32:
+		return GetSparkDivKernel<A_TYPE, int32_t, OP>(result_type);
+	case PhysicalType::INT64:
+		return GetSparkDivKernel<A_TYPE, int64_t, OP>(result_type);
+	case PhysicalType::INT128:
+		return GetSparkDivKernel<A_TYPE, hugeint_t, OP>(result_type);
+	default:
+		throw InternalException("Unexpected physical type for DECIMAL divisor");
+	}
+}
+
+template <typename OP>
+static scalar_function_t GetSparkDivKernel(PhysicalType a_type, PhysicalType b_type, PhysicalType result_type) {
+	switch (a_type) {
+	case PhysicalType::INT16:
+		return GetSparkDivKernel<int16_t, OP>(b_type, result_type);
+	case PhysicalType::INT32:
+		return GetSparkDivKernel<int32_t, OP>(b_type, result_type);
+	case PhysicalType::INT64:
+		return GetSparkDivKernel<int64_t, OP>(b_type, result_type);
+	case PhysicalType::INT128:
+		return GetSparkDivKernel<hugeint_t, OP>(b_type, result_type);
+	default:
+		throw InternalException("Unexpected physical type for DECIMAL dividend");
+	}
+}
+
+// 64-bit operands only: the instantiations behind GetSparkDivScaledKernel.
+template <typename A_TYPE, typename OP>
+static scalar_function_t GetSparkDivNarrowKernel(PhysicalType b_type, PhysicalType result_type) {
+	switch (b_type) {
+	case PhysicalType::INT16:
+		return GetSparkDivKernel<A_TYPE, int16_t, OP>(result_type);
+	case PhysicalType::INT32:
+		return GetSparkDivKernel<A_TYPE, int32_t, OP>(result_type);
+	case PhysicalType::INT64:
+		return GetSparkDivKernel<A_TYPE, int64_t, OP>(result_type);
+	default:
+		throw InternalException("Unexpected physical type for DECIMAL divisor");
+	}
+}
+
+template <typename OP>
+static scalar_function_t GetSparkDivNarrowKernel(PhysicalType a_type, PhysicalType b_type, PhysicalType result_type) {
+	switch (a_type) {
+	case PhysicalType::INT16:
+		return GetSparkDivNarrowKernel<int16_t, OP>(b_type, result_type);
+	case PhysicalType::INT32:
+		return GetSparkDivNarrowKernel<int32_t, OP>(b_type, result_type);
+	case PhysicalType::INT64:
+		return GetSparkDivNarrowKernel<int64_t, OP>(b_type, result_type);
+	default:
+		throw InternalException("Unexpected physical type for DECIMAL dividend");
+	}
+}
+
+// Narrow kernels (SparkDiv64Op, SparkDivNarrowOp) with scale_adj as a template
+// argument for the range typical Spark divisions produce, 6 to 12: the scaling
+// multiply takes an immediate and the overflow branches fold away. Other scales
+// and hugeint operands keep the runtime-scale kernel.
+template <typename OP>
+static scalar_function_t GetSparkDivScaledKernel(uint32_t scale_adj, PhysicalType a_type, PhysicalType b_type,
+                                                 PhysicalType result_type) {
+	if (a_type == PhysicalType::INT128 || b_type == PhysicalType::INT128) {
+		return GetSparkDivKernel<OP>(a_type, b_type, result_type);
+	}
+	switch (scale_adj) {
+	case 6:
+		return GetSparkDivNarrowKernel<SparkDivFixedScaleOp<OP, 6>>(a_type, b_type, result_type);
+	case 7:
+		return GetSparkDivNarrowKernel<SparkDivFixedScaleOp<OP, 7>>(a_type, b_type, result_type);
+	case 8:
+		return GetSparkDivNarrowKernel<SparkDivFixedScaleOp<OP, 8>>(a_type, b_type, result_type);
+	case 9:
+		return GetSparkDivNarrowKernel<SparkDivFixedScaleOp<OP, 9>>(a_type, b_type, result_type);
+	case 10:
+		return GetSparkDivNarrowKernel<SparkDivFixedScaleOp<OP, 10>>(a_type, b_type, result_type);
+	case 11:
+		return GetSparkDivNarrowKernel<SparkDivFixedScaleOp<OP, 11>>(a_type, b_type, result_type);
+	case 12:
+		return GetSparkDivNarrowKernel<SparkDivFixedScaleOp<OP, 12>>(a_type, b_type, result_type);
+	default:
+		return GetSparkDivKernel<OP>(a_type, b_type, result_type);
+	}
 }
 
 // ---------------------------------------------------------------------------
@@ -87,8 +623,8 @@ static void SparkDivExec(DataChunk &args, ExpressionState &state, Vector &result
 // ---------------------------------------------------------------------------
 
 static unique_ptr<FunctionData> BindSparkDecimalDiv(ClientContext &context,
-                                                     ScalarFunction &bound_function,
-                                                     vector<unique_ptr<Expression>> &arguments) {
+                                                    ScalarFunction &bound_function,
+                                                    vector<unique_ptr<Expression>> &arguments) {
 	auto &type_a = arguments[0]->return_type;
 	auto &type_b = arguments[1]->return_type;
 
@@ -108,34 +644,118 @@ static unique_ptr<FunctionData> BindSparkDecimalDiv(ClientContext &context,
 	// This is always >= 0 for valid Spark inputs
 	uint32_t scale_adj = static_cast<uint32_t>(result.scale) - static_cast<uint32_t>(s1) + static_cast<uint32_t>(s2);
 
-	// Promote both inputs to DECIMAL(38, s_original) -> hugeint_t physical type
-	// DuckDB will insert implicit casts
-	bound_function.arguments[0] = LogicalType::DECIMAL(38, s1);
-	bound_function.arguments[1] = LogicalType::DECIMAL(38, s2);
+	// Keep both inputs at their declared DECIMAL type so that no implicit cast
+	// is inserted; the kernel is templated on the physical input types instead.
+	bound_function.arguments[0] = type_a;
+	bound_function.arguments[1] = type_b;
 
 	// Set result type
 	auto result_type = LogicalType::DECIMAL(result.precision, result.scale);
 	bound_function.return_type = result_type;
 
-	// Select implementation based on result physical type
-	switch (result_type.InternalType()) {
-	case PhysicalType::INT16:
-		bound_function.function = SparkDivExec<int16_t>;
-		break;
-	case PhysicalType::INT32:
-		bound_function.function = SparkDivExec<int32_t>;
-		break;
-	case PhysicalType::INT64:
-		bound_function.function = SparkDivExec<int64_t>;
-		break;
-	case PhysicalType::INT128:
-		bound_function.function = SparkDivExec<hugeint_t>;
-		break;
-	default:
-		throw InternalException("Unexpected physical type for DECIMAL result");
+	// Select implementation based on the input and result physical types.
+	// |a| < 10^p1, so a * 10^scale_adj fits in int64_t whenever p1 + scale_adj <= 18.
+	auto a_type = type_a.InternalType();
+	auto b_type = type_b.InternalType();
+	if (a_type == PhysicalType::INT128 || b_type == PhysicalType::INT128) {
+		bound_function.function = GetSparkDivKernel<SparkDivWideOp>(a_type, b_type, result_type.InternalType());
+	} else if (p1 + scale_adj <= 18) {
+		bound_function.function =
+		    GetSparkDivScaledKernel<SparkDiv64Op>(scale_adj, a_type, b_type, result_type.InternalType());
+	} else {
+		bound_function.function =
+		    GetSparkDivScaledKernel<SparkDivNarrowOp>(scale_adj, a_type, b_type, result_type.InternalType());
 	}
 
-	return make_uniq<SparkDivBindData>(scale_adj);
+	// Constant divisor (e.g. `price / 100.00`): precompute its reciprocal, or its
+	// exact multiplier, once. Foldable divisor expressions become constants in
+	// the constant-divisor rewrite (spark_optimizer.cpp), which binds again.
+	if (arguments[1]->GetExpressionClass() == ExpressionClass::BOUND_CONSTANT) {
+		auto &divisor_value = arguments[1]->Cast<BoundConstantExpression>().value;
+		if (!divisor_value.IsNull()) {
+			__int128 b_val = DecimalValueToInt128(divisor_value);
+			if (b_val != 0) {
+				SparkConstantDivisor divisor(b_val);
+				divisor.SetExactMultiplier(scale_adj);
+				auto bind_data = make_uniq<SparkDivBindData>(scale_adj, divisor);
+				bind_data->may_overflow_128 = p1 + scale_adj > SPARK_MAX_PRECISION;
+				bind_data->check_range = p1 + scale_adj > result.precision;
+				bind_data->ansi = SparkAnsiEnabled(context);
+				return std::move(bind_data);
+			}
+		}
+	}
+
+	// |a * 10^scale_adj / b| < 10^(p1 + scale_adj), so the quotient can only
+	// overflow the result precision when that was capped at 38
+	auto bind_data = make_uniq<SparkDivBindData>(scale_adj);
+	bind_data->may_overflow_128 = p1 + scale_adj > SPARK_MAX_PRECISION;
+	bind_data->check_range = p1 + scale_adj > result.precision;
+	bind_data->ansi = SparkAnsiEnabled(context);
+	return std::move(bind_data);
+}
+
+// ---------------------------------------------------------------------------
+// Statistics propagation
+// ---------------------------------------------------------------------------
+// Division is monotone in each argument while the divisor keeps its sign, and
+// HALF_UP rounding is monotone too, so when the divisor range excludes zero the
+// quotients of the four corners bound the result.
+//
+// The input ranges also let the kernel be narrowed beyond what the declared
+// types allow, e.g. a DECIMAL(38,2) column whose values fit in int64 runs the
+// 64-bit kernel when a * 10^scale_adj provably fits.
+
+static unique_ptr<BaseStatistics> SparkDecimalDivStats(ClientContext &context, FunctionStatisticsInput &input) {
+	auto &child_stats = input.child_stats;
+	auto &expr = input.expr;
+
+	__int128 a_min, a_max, b_min, b_max;
+	if (!TryGetDecimalStatsBounds(child_stats[0], a_min, a_max) ||
+	    !TryGetDecimalStatsBounds(child_stats[1], b_min, b_max)) {
+		return nullptr;
+	}
+
+	// Bind data is shared by copies of the expression and compared through
+	// Equals, so the narrowed flags go into a new copy that replaces it
+	auto narrowed_data = input.bind_data->Copy();
+	auto &bind_data = narrowed_data->Cast<SparkDivBindData>();
+	SparkDivScale scale(bind_data.scale_adj);
+	if (bind_data.may_overflow_128 && std::max(Abs128(a_min), Abs128(a_max)) <= scale.MaxDividend128()) {
+		// No dividend in range reaches the 256-bit path: skip the counting pass
+		bind_data.may_overflow_128 = false;
+	}
+	auto a_type = expr.children[0]->return_type.InternalType();
+	auto b_type = expr.children[1]->return_type.InternalType();
+	auto result_physical = expr.return_type.InternalType();
+	if (BoundsFitInt64(a_min, a_max) && BoundsFitInt64(b_min, b_max)) {
+		unsigned __int128 abs_a_max = std::max(Abs128(a_min), Abs128(a_max));
+		auto int64_max = static_cast<unsigned __int128>(NumericLimits<int64_t>::Maximum());
+		if (scale.pow10_64 != 0 && abs_a_max <= int64_max / static_cast<uint64_t>(scale.pow10_64)) {
+			expr.function.function =
+			    GetSparkDivScaledKernel<SparkDiv64Op>(bind_data.scale_adj, a_type, b_type, result_physical);
+		} else if (a_type == PhysicalType::INT128 || b_type == PhysicalType::INT128) {
+			expr.function.function = GetSparkDivKernel<SparkDivNarrowOp>(a_type, b_type, result_physical);
+		}
+	}
+
+	// A divisor range that contains zero produces NULLs and unbounded quotients
+	unique_ptr<BaseStatistics> result_stats;
+	auto width = DecimalType::GetWidth(expr.return_type);
+	__int128 corners[4];
+	if (!(b_min <= 0 && b_max >= 0) && TrySparkDivideBound(a_min, b_min, scale, width, corners[0]) &&
+	    TrySparkDivideBound(a_min, b_max, scale, width, corners[1]) &&
+	    TrySparkDivideBound(a_max, b_min, scale, width, corners[2]) &&
+	    TrySparkDivideBound(a_max, b_max, scale, width, corners[3])) {
+		// Every quotient in range fits the result precision: no range check needed
+		bind_data.check_range = false;
+		auto result_min = std::min(std::min(corners[0], corners[1]), std::min(corners[2], corners[3]));
+		auto result_max = std::max(std::max(corners[0], corners[1]), std::max(corners[2], corners[3]));
+		bool can_have_null = child_stats[0].CanHaveNull() || child_stats[1].CanHaveNull();
+		result_stats = MakeDecimalStats(expr.return_type, result_min, result_max, can_have_null);
+	}
+	expr.bind_info = std::move(narrowed_data);
+	return result_stats;
 }
 
 // ---------------------------------------------------------------------------
@@ -144,12 +764,20 @@ static unique_ptr<FunctionData> BindSparkDecimalDiv(ClientContext &context,
 
 static void LoadInternal(ExtensionLoader &loader) {
 	vector<LogicalType> args = {LogicalType::ANY, LogicalType::ANY};
-	ScalarFunction func("spark_decimal_div", std::move(args), LogicalType::ANY, SparkDivExec<hugeint_t>,
-	                    BindSparkDecimalDiv);
+	ScalarFunction func("spark_decimal_div", std::move(args), LogicalType::ANY,
+	                    SparkDivExec<hugeint_t, hugeint_t, hugeint_t, SparkDivWideOp>, BindSparkDecimalDiv);
 	func.null_handling = FunctionNullHandling::SPECIAL_HANDLING;
+	func.statistics = SparkDecimalDivStats;
 
 	loader.RegisterFunction(func);
 
+	// Overflow handling for all DECIMAL results: NULL (legacy) or error (ANSI)
+	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+	config.AddExtensionOption(SPARK_ANSI_SETTING,
+	                          "Raise an error instead of returning NULL when a Spark DECIMAL result overflows its "
+	                          "precision (spark.sql.ansi.enabled)",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(false));
+
 	// Also override the `/` operator for DECIMAL types so that raw SQL
 	// (spark.sql("SELECT a / b ...")) automatically uses Spark semantics.
 	// We register a `/` overload with DECIMAL arguments. DuckDB merges
@@ -157,14 +785,61 @@ static void LoadInternal(ExtensionLoader &loader) {
 	// resolves to our Spark-compatible function while int/float/etc.
 	// continue using the built-in behavior.
 	ScalarFunction div_func("/", {LogicalType::DECIMAL(38, 0), LogicalType::DECIMAL(38, 0)},
-	                        LogicalType::ANY, SparkDivExec<hugeint_t>, BindSparkDecimalDiv);
+	                        LogicalType::ANY, SparkDivExec<hugeint_t, hugeint_t, hugeint_t, SparkDivWideOp>,
+	                        BindSparkDecimalDiv);
 	div_func.null_handling = FunctionNullHandling::SPECIAL_HANDLING;
+	div_func.statistics = SparkDecimalDivStats;
 	loader.AddFunctionOverload(div_func);
 
+	// Spark-semantics multiply/add/subtract, including the `*`, `+` and `-`
+	// DECIMAL operator overloads
+	RegisterSparkArithmeticFunctions(loader);
+
+	// Spark DECIMAL `div`, `%` and pmod
+	RegisterSparkDivModFunctions(loader);
+
+	// spark_decimal_div(a, b) compared with c, without the quotient
+	RegisterSparkDivCompareFunctions(loader);
+
+	// Spark-compatible VARCHAR <-> DECIMAL conversion
+	RegisterSparkCastFunctions(loader);
+
+	// Spark ROUND/BROUND/CEIL/FLOOR on DECIMAL
+	RegisterSparkRoundFunctions(loader);
+
+	// Spark hash() / xxhash64(), bit-for-bit, for bucketing and partitioning
+	RegisterSparkHashFunctions(loader);
+
 	// Spark-compatible aggregate functions
 	loader.RegisterFunction(CreateSparkSumFunctionSet());
 	loader.RegisterFunction(CreateSparkAvgFunctionSet());
+	// Shared sum + count state behind spark_sum_count (see spark_optimizer.cpp)
+	loader.RegisterFunction(CreateSparkSumCountFunctionSet());
+	// spark_sum(a) / spark_sum(b) in one state, behind the sum-ratio rewrite
+	loader.RegisterFunction(CreateSparkSumRatioFunctionSet());
+	loader.RegisterFunction(CreateSparkSumDistinctFunctionSet());
+	loader.RegisterFunction(CreateSparkAvgDistinctFunctionSet());
+	loader.RegisterFunction(CreateSparkVarianceFunctionSet<SparkVarSampOp>());
+	loader.RegisterFunction(CreateSparkVarianceFunctionSet<SparkVarPopOp>());
+	loader.RegisterFunction(CreateSparkVarianceFunctionSet<SparkStddevSampOp>());
+	loader.RegisterFunction(CreateSparkVarianceFunctionSet<SparkStddevPopOp>());
+	// Sketches: HyperLogLog++ and Greenwald-Khanna, on the scaled DECIMAL values
+	loader.RegisterFunction(CreateSparkApproxCountDistinctFunctionSet());
+	loader.RegisterFunction(CreateSparkPercentileApproxFunctionSet());
+	// Partial states for distributed aggregation: spark_{sum,avg}_state / spark_{sum,avg}_merge
+	loader.RegisterFunction(CreateSparkPartialStateFunctionSet<SparkSumPartialState>());
+	loader.RegisterFunction(CreateSparkPartialStateFunctionSet<SparkAvgPartialState>());
+	loader.RegisterFunction(CreateSparkPartialMergeFunctionSet<SparkSumPartialState>());
+	loader.RegisterFunction(CreateSparkPartialMergeFunctionSet<SparkAvgPartialState>());
 	// COUNT not needed — DuckDB COUNT already returns BIGINT (matches Spark)
+
+	// Plan rewrites: constant divisors are folded, sibling spark_sum / spark_avg /
+	// count share one state, spark_sum(a) / spark_sum(b) becomes
+	// spark_sum_ratio(a, b), and division comparisons skip the quotient
+	RegisterSparkOptimizerRules(loader);
+
+	// Slow-path / edge-case counters: thdck_spark_stats(), thdck_spark_stats_reset()
+	RegisterSparkCounterFunctions(loader);
 }
 
 // ---------------------------------------------------------------------------